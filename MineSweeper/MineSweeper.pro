@@ -8,9 +8,35 @@ SOURCES += ./src/MineSweeperGUI.cpp
 SOURCES += ./src/MineSweeperCore.cpp
 SOURCES += ./src/BoardCore.cpp
 SOURCES += ./src/CellCore.cpp
+SOURCES += ./src/ThreadPoolCore.cpp
+SOURCES += ./src/RandomCore.cpp
+SOURCES += ./src/BitBoardCore.cpp
+SOURCES += ./src/ChunkBoardCore.cpp
+SOURCES += ./src/MappedFileCore.cpp
+SOURCES += ./src/BoardFileCore.cpp
+SOURCES += ./src/BoardCacheCore.cpp
+SOURCES += ./src/CommandTokenizerCore.cpp
+SOURCES += ./src/OutputSinkCore.cpp
+SOURCES += ./src/CommandBatchCore.cpp
+SOURCES += ./src/ServerCore.cpp
+SOURCES += ./src/BinaryProtocolCore.cpp
+SOURCES += ./src/SessionPoolCore.cpp
 HEADERS += ./src/MineSweeperGUI.h
 HEADERS += ./src/MineSweeperCore.h
 HEADERS += ./src/BoardCore.h
 HEADERS += ./src/CellCore.h
+HEADERS += ./src/ThreadPoolCore.h
+HEADERS += ./src/RandomCore.h
+HEADERS += ./src/BitBoardCore.h
+HEADERS += ./src/ChunkBoardCore.h
+HEADERS += ./src/MappedFileCore.h
+HEADERS += ./src/BoardFileCore.h
+HEADERS += ./src/BoardCacheCore.h
+HEADERS += ./src/CommandTokenizerCore.h
+HEADERS += ./src/OutputSinkCore.h
+HEADERS += ./src/CommandBatchCore.h
+HEADERS += ./src/ServerCore.h
+HEADERS += ./src/BinaryProtocolCore.h
+HEADERS += ./src/SessionPoolCore.h
 CONFIG += console
 RESOURCES += resource.qrc
@@ -0,0 +1,60 @@
+﻿/*****************************************************************//**
+ * File : BenchCommon.h
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the benchmark header of MineSweeperExample
+ *********************************************************************/
+
+#pragma once
+#ifndef _BENCHCOMMON_H_
+#define _BENCHCOMMON_H_
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+/**
+ * Intent : 重複執行repeat次，回傳最快一次的時間 (毫秒)，每次執行前先呼叫setup (不計時)
+ * Pre : repeat > 0
+ * Post :
+ * \param repeat 重複次數
+ * \param setup 每次執行前的準備
+ * \param task 要計時的工作
+ * \return 最快一次的時間 (毫秒)
+ */
+template <typename Setup, typename Task>
+double BestOfMs(int repeat, const Setup& setup, const Task& task)
+{
+	double best = 0.0;
+	for (int i = 0; i < repeat; i++)
+	{
+		setup();
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		task();
+		double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if (i == 0 || elapsed < best)
+		{
+			best = elapsed;
+		}
+	}
+	return best;
+}
+
+/**
+ * Intent : 讀取第index個命令列參數，沒有指定時使用預設值
+ * Pre :
+ * Post :
+ * \param argc 參數數量
+ * \param argv 參數
+ * \param index 參數位置
+ * \param defaultValue 預設值
+ * \return 參數的數值
+ */
+inline double BenchArg(int argc, char** argv, int index, double defaultValue)
+{
+	return index < argc ? std::atof(argv[index]) : defaultValue;
+}
+
+#endif // !_BENCHCOMMON_H_
@@ -0,0 +1,81 @@
+﻿/*****************************************************************//**
+ * File : FloodFillBench.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the benchmark implementation of MineSweeperExample
+ *********************************************************************/
+
+//很寬的盤面上各種flood fill模式的效能測試 : 在同一列上平均分散點擊數次，只計算FloodOpen的時間
+//QUEUE為逐格擴散的做法 (原本遞迴版本改寫成的佇列)，其餘模式開啟的格子數必須與QUEUE相同
+//bitboard模式在第一次點擊時才建立bitboard，建立的時間也包含在內
+//用法 : FloodFillBench [rows] [cols] [clicks] [repeat]，預設為 8 1000000 6 3
+
+#include <cstdio>
+
+#include "BenchCommon.h"
+#include "BoardCore.h"
+
+using namespace std;
+
+int main(int argc, char** argv)
+{
+	int rows = (int)BenchArg(argc, argv, 1, 8);
+	int cols = (int)BenchArg(argc, argv, 2, 1000000);
+	int clicks = (int)BenchArg(argc, argv, 3, 6);
+	int repeat = (int)BenchArg(argc, argv, 4, 3);
+	static const float bombRates[] = { 0.0f, 0.02f, 0.1f };
+	static const struct
+	{
+		const char* name;
+		FloodFillMode mode;
+	} modes[] =
+	{
+		{ "queue", FloodFillMode::QUEUE },
+		{ "scanline", FloodFillMode::SCANLINE },
+		{ "bitboard", FloodFillMode::BITBOARD },
+		{ "component", FloodFillMode::COMPONENT },
+	};
+
+	//只比較演算法本身，固定使用一個執行緒
+	BoardCore board;
+	board.SetThreadCount(1);
+
+	printf("board %d x %d, %d clicks, best of %d, 1 thread (load not included)\n", rows, cols, clicks, repeat);
+
+	bool resultsMatch = true;
+	for (float bombRate : bombRates)
+	{
+		int expectedOpened = -1;
+		for (const auto& entry : modes)
+		{
+			//每次計時前重新產生相同的盤面 (component模式在載入時標記0區域，不計時)
+			double elapsedMs = BestOfMs(repeat, [&]
+			{
+				board.Clear();
+				board.SetFloodFillMode(entry.mode);
+				board.Load(rows, cols);
+				board.GenerateRandomRate(bombRate, 1);
+			}, [&]
+			{
+				for (int click = 0; click < clicks; click++)
+				{
+					board.FloodOpen(rows / 2, (int)((long long)cols * (2 * click + 1) / (2 * clicks)));
+				}
+			});
+
+			int opened = board.GetOpenBlankCount();
+			if (expectedOpened < 0)
+			{
+				expectedOpened = opened;
+			}
+			resultsMatch = resultsMatch && opened == expectedOpened;
+
+			printf("rate %.2f  %-9s %9.1f ms  %10d opened\n", bombRate, entry.name, elapsedMs, opened);
+		}
+	}
+
+	printf("opened cells %s\n", resultsMatch ? "match" : "MISMATCH");
+	return resultsMatch ? 0 : 1;
+}
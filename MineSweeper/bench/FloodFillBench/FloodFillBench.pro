@@ -0,0 +1,3 @@
+TARGET = FloodFillBench
+include(../bench.pri)
+SOURCES += ./FloodFillBench.cpp
@@ -0,0 +1,81 @@
+﻿/*****************************************************************//**
+ * File : NearCountBench.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the benchmark implementation of MineSweeperExample
+ *********************************************************************/
+
+//RefreshNearBombCount的效能測試 : 逐格查周遭8格 (原本的做法) 與逐列的SIMD box filter比較
+//用法 : NearCountBench [rows] [cols] [bombRate] [repeat]，預設為 4000 4000 0.15 5
+
+#include <cstdio>
+#include <vector>
+
+#include "BenchCommon.h"
+#include "BoardCore.h"
+
+using namespace std;
+
+int main(int argc, char** argv)
+{
+	int rows = (int)BenchArg(argc, argv, 1, 4000);
+	int cols = (int)BenchArg(argc, argv, 2, 4000);
+	float bombRate = (float)BenchArg(argc, argv, 3, 0.15);
+	int repeat = (int)BenchArg(argc, argv, 4, 5);
+
+	//只比較演算法本身，固定使用一個執行緒
+	BoardCore board;
+	board.SetThreadCount(1);
+	board.Load(rows, cols);
+	board.GenerateRandomRate(bombRate, 1);
+
+	//原本的做法 : 每一格各自用GetNearBombCount查周遭8格
+	double perCellMs = BestOfMs(repeat, [] {}, [&]
+	{
+		for (int i = 0; i < rows; i++)
+		{
+			for (int j = 0; j < cols; j++)
+			{
+				board.GetCell(i, j)->SetNearBombCount(board.GetNearBombCount(i, j));
+			}
+		}
+	});
+
+	vector<int> expected((size_t)rows * cols);
+	for (int i = 0; i < rows; i++)
+	{
+		for (int j = 0; j < cols; j++)
+		{
+			expected[(size_t)i * cols + j] = board.GetCell(i, j)->GetNearBombCount();
+		}
+	}
+
+	//目前的做法 : Refresh (逐列的box filter，另外還包含total count與open count的掃描)
+	double refreshMs = BestOfMs(repeat, [] {}, [&] { board.Refresh(); });
+
+	//兩種做法的結果必須相同
+	long long mismatchCount = 0;
+	for (int i = 0; i < rows; i++)
+	{
+		for (int j = 0; j < cols; j++)
+		{
+			mismatchCount += board.GetCell(i, j)->GetNearBombCount() != expected[(size_t)i * cols + j];
+		}
+	}
+
+	//整個載入流程 : 配置記憶體、產生炸彈、Refresh
+	double loadMs = BestOfMs(repeat, [&] { board.Clear(); }, [&]
+	{
+		board.Load(rows, cols);
+		board.GenerateRandomRate(bombRate, 1);
+	});
+
+	printf("board %d x %d, bomb rate %.2f, best of %d, 1 thread\n", rows, cols, bombRate, repeat);
+	printf("per-cell near count   %10.1f ms\n", perCellMs);
+	printf("Refresh (box filter)  %10.1f ms  (%.1fx)\n", refreshMs, perCellMs / refreshMs);
+	printf("Load + RandomRate     %10.1f ms\n", loadMs);
+	printf("mismatched cells      %10lld\n", mismatchCount);
+	return mismatchCount == 0 ? 0 : 1;
+}
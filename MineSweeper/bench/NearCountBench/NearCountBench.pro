@@ -0,0 +1,3 @@
+TARGET = NearCountBench
+include(../bench.pri)
+SOURCES += ./NearCountBench.cpp
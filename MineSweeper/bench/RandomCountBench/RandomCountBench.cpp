@@ -0,0 +1,67 @@
+﻿/*****************************************************************//**
+ * File : RandomCountBench.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the benchmark implementation of MineSweeperExample
+ *********************************************************************/
+
+//RandomCount放置炸彈的效能測試 : 隨機挑格子、挑到炸彈就重抽 (原本的做法) 與Floyd抽樣比較，炸彈密度從1%到100%
+//用法 : RandomCountBench [rows] [cols] [repeat]，預設為 500 500 5
+
+#include <cstdio>
+
+#include "BenchCommon.h"
+#include "BoardCore.h"
+#include "RandomCore.h"
+
+using namespace std;
+
+int main(int argc, char** argv)
+{
+	int rows = (int)BenchArg(argc, argv, 1, 500);
+	int cols = (int)BenchArg(argc, argv, 2, 500);
+	int repeat = (int)BenchArg(argc, argv, 3, 5);
+	static const int densities[] = { 1, 10, 25, 50, 75, 90, 99, 100 };
+
+	//只比較演算法本身，固定使用一個執行緒
+	//每次計時前先Clear再Load (大小相同時Load不會清除格子)
+	BoardCore board;
+	board.SetThreadCount(1);
+
+	printf("board %d x %d, best of %d, 1 thread (time includes Refresh)\n", rows, cols, repeat);
+	printf("density      rejection          Floyd\n");
+
+	bool countsMatch = true;
+	for (int density : densities)
+	{
+		int bombCount = (int)((long long)rows * cols * density / 100);
+
+		//原本的做法 : 隨機挑一格，已經是炸彈就重抽，密度接近100%時重抽次數急遽增加
+		double rejectionMs = BestOfMs(repeat, [&] { board.Clear(); board.Load(rows, cols); }, [&]
+		{
+			RandomCore random(1, 0);
+			for (int placed = 0; placed < bombCount; placed++)
+			{
+				CellCore* cell;
+				do
+				{
+					cell = board.GetCell((int)random.NextBelow((std::uint64_t)rows), (int)random.NextBelow((std::uint64_t)cols));
+				} while (cell->IsBomb());
+				cell->SetBomb(true);
+			}
+			board.Refresh();
+		});
+		countsMatch = countsMatch && board.GetTotalBombCount() == bombCount;
+
+		//目前的做法 : Floyd抽樣，不論密度都剛好抽bombCount次
+		double floydMs = BestOfMs(repeat, [&] { board.Clear(); board.Load(rows, cols); }, [&] { board.GenerateRandomCount(bombCount, 1); });
+		countsMatch = countsMatch && board.GetTotalBombCount() == bombCount;
+
+		printf("%6d%% %11.2f ms %11.2f ms\n", density, rejectionMs, floydMs);
+	}
+
+	printf("bomb counts %s\n", countsMatch ? "match" : "MISMATCH");
+	return countsMatch ? 0 : 1;
+}
@@ -0,0 +1,3 @@
+TARGET = RandomCountBench
+include(../bench.pri)
+SOURCES += ./RandomCountBench.cpp
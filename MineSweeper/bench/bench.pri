@@ -0,0 +1,19 @@
+# 效能測試共用的設定 : 只編譯盤面相關的Core api，不需要Qt
+TEMPLATE = app
+CONFIG += console c++14 release
+CONFIG -= qt app_bundle
+msvc: QMAKE_CXXFLAGS += /utf-8
+INCLUDEPATH += $$PWD/../src $$PWD
+SOURCES += $$PWD/../src/BoardCore.cpp
+SOURCES += $$PWD/../src/CellCore.cpp
+SOURCES += $$PWD/../src/ThreadPoolCore.cpp
+SOURCES += $$PWD/../src/RandomCore.cpp
+SOURCES += $$PWD/../src/BitBoardCore.cpp
+SOURCES += $$PWD/../src/OutputSinkCore.cpp
+HEADERS += $$PWD/../src/BoardCore.h
+HEADERS += $$PWD/../src/CellCore.h
+HEADERS += $$PWD/../src/ThreadPoolCore.h
+HEADERS += $$PWD/../src/RandomCore.h
+HEADERS += $$PWD/../src/BitBoardCore.h
+HEADERS += $$PWD/../src/OutputSinkCore.h
+HEADERS += $$PWD/BenchCommon.h
@@ -0,0 +1,5 @@
+# 效能測試 : 每個子目錄是一個獨立的命令列程式，執行方式見各程式開頭的說明
+TEMPLATE = subdirs
+SUBDIRS += NearCountBench
+SUBDIRS += RandomCountBench
+SUBDIRS += FloodFillBench
@@ -0,0 +1,219 @@
+﻿/*****************************************************************//**
+ * File : BinaryProtocolCore.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api implementation of MineSweeperExample
+ *********************************************************************/
+
+#include "BinaryProtocolCore.h"
+
+#include <cstring>
+
+using namespace std;
+
+//request frame各欄位的位置
+static const size_t REQUEST_MAGIC = 0;
+static const size_t REQUEST_OPCODE = 1;
+static const size_t REQUEST_OPTION = 2;
+static const size_t REQUEST_FLAGS = 3;
+static const size_t REQUEST_RATE = 4;
+static const size_t REQUEST_ROW = 8;
+static const size_t REQUEST_COL = 16;
+static const size_t REQUEST_ROW_COUNT = 24;
+static const size_t REQUEST_COL_COUNT = 32;
+static const size_t REQUEST_COUNT = 40;
+static const size_t REQUEST_SEED = 48;
+
+//response header各欄位的位置
+static const size_t RESPONSE_STATUS = 0;
+static const size_t RESPONSE_STATE = 1;
+static const size_t RESPONSE_OUTCOME = 2;
+static const size_t RESPONSE_OPCODE = 3;
+static const size_t RESPONSE_CHANGE_COUNT = 4;
+static const size_t RESPONSE_PAYLOAD_SIZE = 8;
+static const size_t RESPONSE_BOMB_COUNT = 16;
+static const size_t RESPONSE_FLAG_COUNT = 24;
+static const size_t RESPONSE_OPEN_BLANK_COUNT = 32;
+static const size_t RESPONSE_REMAIN_BLANK_COUNT = 40;
+
+/**
+ * Intent : 解析一個request frame
+ * Pre :
+ * Post : COMPLETE時request與frameSize (含檔名) 有效，檔名在data + REQUEST_SIZE
+ * \param data 資料
+ * \param size 資料大小
+ * \param request 輸出的指令
+ * \param frameSize 輸出的frame大小
+ * \return 解析結果
+ */
+BinaryFrameStatus BinaryProtocolCore::ParseRequest(const unsigned char* data, size_t size, BinaryRequest& request, size_t& frameSize)
+{
+	//開頭的magic與opcode不需要等到整個frame就能判斷
+	if (size > REQUEST_MAGIC && data[REQUEST_MAGIC] != MAGIC)
+	{
+		return BinaryFrameStatus::INVALID;
+	}
+	if (size > REQUEST_OPCODE && (data[REQUEST_OPCODE] < (unsigned char)BinaryOpcode::LOAD || data[REQUEST_OPCODE] > (unsigned char)BinaryOpcode::QUIT))
+	{
+		return BinaryFrameStatus::INVALID;
+	}
+	if (size < REQUEST_SIZE)
+	{
+		return BinaryFrameStatus::INCOMPLETE;
+	}
+
+	request.opcode = (BinaryOpcode)data[REQUEST_OPCODE];
+	request.option = data[REQUEST_OPTION];
+	request.flags = data[REQUEST_FLAGS];
+	uint32_t rateBits = (uint32_t)Load(data + REQUEST_RATE, 4);
+	memcpy(&request.rate, &rateBits, sizeof(request.rate));
+	request.row = (long long)Load(data + REQUEST_ROW, 8);
+	request.col = (long long)Load(data + REQUEST_COL, 8);
+	request.rowCount = (long long)Load(data + REQUEST_ROW_COUNT, 8);
+	request.colCount = (long long)Load(data + REQUEST_COL_COUNT, 8);
+	request.count = (long long)Load(data + REQUEST_COUNT, 8);
+	request.seed = Load(data + REQUEST_SEED, 8);
+
+	//帶檔名的指令 : 檔名長度放在count
+	frameSize = REQUEST_SIZE;
+	bool hasPath = request.opcode == BinaryOpcode::SAVE || (request.opcode == BinaryOpcode::LOAD && request.option == (std::uint8_t)BinaryLoadType::BOARD_FILE);
+	if (hasPath)
+	{
+		if (request.count < 0 || request.count > MAX_PATH_SIZE)
+		{
+			return BinaryFrameStatus::INVALID;
+		}
+		frameSize += (size_t)request.count;
+	}
+
+	return size < frameSize ? BinaryFrameStatus::INCOMPLETE : BinaryFrameStatus::COMPLETE;
+}
+
+/**
+ * Intent : 把指令編碼成request frame (不含檔名)
+ * Pre : data至少有REQUEST_SIZE個byte
+ * Post :
+ * \param request 指令
+ * \param data 輸出的位置
+ */
+void BinaryProtocolCore::EncodeRequest(const BinaryRequest& request, unsigned char* data)
+{
+	uint32_t rateBits;
+	memcpy(&rateBits, &request.rate, sizeof(rateBits));
+
+	data[REQUEST_MAGIC] = MAGIC;
+	data[REQUEST_OPCODE] = (unsigned char)request.opcode;
+	data[REQUEST_OPTION] = request.option;
+	data[REQUEST_FLAGS] = request.flags;
+	Store(data + REQUEST_RATE, rateBits, 4);
+	Store(data + REQUEST_ROW, (uint64_t)request.row, 8);
+	Store(data + REQUEST_COL, (uint64_t)request.col, 8);
+	Store(data + REQUEST_ROW_COUNT, (uint64_t)request.rowCount, 8);
+	Store(data + REQUEST_COL_COUNT, (uint64_t)request.colCount, 8);
+	Store(data + REQUEST_COUNT, (uint64_t)request.count, 8);
+	Store(data + REQUEST_SEED, request.seed, 8);
+}
+
+/**
+ * Intent : 把回應編碼成response header
+ * Pre : data至少有RESPONSE_SIZE個byte
+ * Post :
+ * \param response 回應
+ * \param data 輸出的位置
+ */
+void BinaryProtocolCore::EncodeResponse(const BinaryResponse& response, unsigned char* data)
+{
+	data[RESPONSE_STATUS] = response.status;
+	data[RESPONSE_STATE] = response.state;
+	data[RESPONSE_OUTCOME] = response.outcome;
+	data[RESPONSE_OPCODE] = (unsigned char)response.opcode;
+	Store(data + RESPONSE_CHANGE_COUNT, response.changeCount, 4);
+	Store(data + RESPONSE_PAYLOAD_SIZE, response.payloadSize, 8);
+	Store(data + RESPONSE_BOMB_COUNT, (uint64_t)response.bombCount, 8);
+	Store(data + RESPONSE_FLAG_COUNT, (uint64_t)response.flagCount, 8);
+	Store(data + RESPONSE_OPEN_BLANK_COUNT, (uint64_t)response.openBlankCount, 8);
+	Store(data + RESPONSE_REMAIN_BLANK_COUNT, (uint64_t)response.remainBlankCount, 8);
+}
+
+/**
+ * Intent : 解析response header
+ * Pre : data至少有RESPONSE_SIZE個byte
+ * Post :
+ * \param data 資料
+ * \param response 輸出的回應
+ */
+void BinaryProtocolCore::DecodeResponse(const unsigned char* data, BinaryResponse& response)
+{
+	response.status = data[RESPONSE_STATUS];
+	response.state = data[RESPONSE_STATE];
+	response.outcome = data[RESPONSE_OUTCOME];
+	response.opcode = (BinaryOpcode)data[RESPONSE_OPCODE];
+	response.changeCount = (uint32_t)Load(data + RESPONSE_CHANGE_COUNT, 4);
+	response.payloadSize = Load(data + RESPONSE_PAYLOAD_SIZE, 8);
+	response.bombCount = (long long)Load(data + RESPONSE_BOMB_COUNT, 8);
+	response.flagCount = (long long)Load(data + RESPONSE_FLAG_COUNT, 8);
+	response.openBlankCount = (long long)Load(data + RESPONSE_OPEN_BLANK_COUNT, 8);
+	response.remainBlankCount = (long long)Load(data + RESPONSE_REMAIN_BLANK_COUNT, 8);
+}
+
+/**
+ * Intent : 把變更格子的位置編碼 (row col各8 byte)
+ * Pre : data至少有CHANGE_SIZE個byte
+ * Post :
+ * \param change 變更格子的位置
+ * \param data 輸出的位置
+ */
+void BinaryProtocolCore::EncodeChange(const CellChange& change, unsigned char* data)
+{
+	Store(data, (uint64_t)change.row, 8);
+	Store(data + 8, (uint64_t)change.col, 8);
+}
+
+/**
+ * Intent : 解析變更格子的位置
+ * Pre : data至少有CHANGE_SIZE個byte
+ * Post :
+ * \param data 資料
+ * \param change 輸出的位置
+ */
+void BinaryProtocolCore::DecodeChange(const unsigned char* data, CellChange& change)
+{
+	change.row = (long long)Load(data, 8);
+	change.col = (long long)Load(data + 8, 8);
+}
+
+/**
+ * Intent : 以little-endian寫入整數
+ * Pre :
+ * Post :
+ * \param data 輸出的位置
+ * \param value 數值
+ * \param size byte數
+ */
+void BinaryProtocolCore::Store(unsigned char* data, std::uint64_t value, int size)
+{
+	for (int i = 0; i < size; i++)
+	{
+		data[i] = (unsigned char)(value >> (8 * i));
+	}
+}
+
+/**
+ * Intent : 以little-endian讀取整數
+ * Pre :
+ * Post :
+ * \param data 資料
+ * \param size byte數
+ * \return 數值
+ */
+std::uint64_t BinaryProtocolCore::Load(const unsigned char* data, int size)
+{
+	uint64_t value = 0;
+	for (int i = 0; i < size; i++)
+	{
+		value |= (uint64_t)data[i] << (8 * i);
+	}
+	return value;
+}
@@ -0,0 +1,208 @@
+﻿/*****************************************************************//**
+ * File : BinaryProtocolCore.h
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api header of MineSweeperExample
+ *********************************************************************/
+
+#pragma once
+#ifndef _BINARYPROTOCOLCORE_H_
+#define _BINARYPROTOCOLCORE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "CellCore.h"
+
+//二進位指令的種類，與文字指令一一對應
+enum class BinaryOpcode : std::uint8_t
+{
+	INVALID = 0, //只出現在回應 : 收到不合法或不完整的frame，payload為錯誤說明，之後的資料不再執行
+	LOAD = 1, //Load (option為BinaryLoadType)
+	START_GAME = 2, //StartGame
+	PRINT = 3, //Print (option為BinaryPrintTarget)
+	LEFT_CLICK = 4, //LeftClick row col
+	RIGHT_CLICK = 5, //RightClick row col
+	REPLAY = 6, //Replay
+	SAVE = 7, //Save BoardFile (檔名接在frame之後)
+	SET = 8, //Set (option為BinarySetOption)
+	QUIT = 9, //Quit
+};
+
+//Load的盤面種類
+enum class BinaryLoadType : std::uint8_t
+{
+	BOARD_FILE, //Load BoardFile (檔名接在frame之後)
+	RANDOM_COUNT, //Load RandomCount rowCount colCount count [seed]
+	RANDOM_RATE, //Load RandomRate rowCount colCount rate [seed]
+	INFINITE_RATE, //Load Infinite rate [seed]
+};
+
+//Print的資訊
+enum class BinaryPrintTarget : std::uint8_t
+{
+	GAME_BOARD,
+	GAME_ANSWER,
+	GAME_STATE,
+	BOMB_COUNT,
+	FLAG_COUNT,
+	OPEN_BLANK_COUNT,
+	REMAIN_BLANK_COUNT,
+	CHUNK_COUNT,
+	SEED,
+	BOARD_CACHE,
+	UNKNOWN, //文字指令中不認得的名稱 (不印出任何資訊)
+};
+
+//Set的選項，值放在count
+enum class BinarySetOption : std::uint8_t
+{
+	THREAD_COUNT, //執行緒數量
+	FIRST_CLICK_SAFE, //0 : Off, 1 : On
+	FLOOD_FILL, //FloodFillMode的數值
+};
+
+//解析frame的結果
+enum class BinaryFrameStatus
+{
+	COMPLETE, //完整的frame
+	INCOMPLETE, //資料還不夠一個frame
+	INVALID, //不是合法的frame (無法再對齊之後的資料)
+};
+
+//二進位指令 (request frame)，欄位依指令種類使用，不使用的欄位為0
+struct BinaryRequest
+{
+	BinaryOpcode opcode = BinaryOpcode::QUIT;
+	std::uint8_t option = 0;
+	std::uint8_t flags = 0;
+	float rate = 0.0f; //RandomRate、Infinite的炸彈機率
+	long long row = 0; //點擊位置、Print範圍的左上角
+	long long col = 0;
+	long long rowCount = 0; //Load的盤面大小、Print範圍的大小
+	long long colCount = 0;
+	long long count = 0; //RandomCount的炸彈數、Set的值、接在frame之後的檔名長度
+	std::uint64_t seed = 0; //隨機種子 (flags有FLAG_SEED時使用)
+};
+
+//二進位回應的header，之後依序接著changeCount個變更格子的位置、changeCount個格子字元、payloadSize個byte的Print內容
+//Load BoardFile因為盤面檔格式錯誤而失敗時，payload為錯誤說明 (與文字回應Failed之後的那一行相同)
+struct BinaryResponse
+{
+	std::uint8_t status = 0; //0 : Failed, 1 : Success
+	std::uint8_t state = 0; //0 : Standby, 1 : Playing, 2 : GameOver
+	std::uint8_t outcome = 0; //0 : 遊戲尚未結束, 1 : 獲勝, 2 : 失敗
+	BinaryOpcode opcode = BinaryOpcode::QUIT; //對應的指令種類
+	std::uint32_t changeCount = 0;
+	std::uint64_t payloadSize = 0;
+	long long bombCount = 0;
+	long long flagCount = 0;
+	long long openBlankCount = 0;
+	long long remainBlankCount = 0;
+};
+
+//固定大小的二進位指令協定 (little-endian) :
+//request : 56 byte的frame (magic opcode option flags rate row col rowCount colCount count seed)，檔名接在frame之後
+//response : 48 byte的header (status state outcome opcode changeCount payloadSize 4個count)，接著變更的格子與Print內容
+class BinaryProtocolCore
+{
+public:
+
+	/**
+	 * Intent : 解析一個request frame
+	 * Pre :
+	 * Post : COMPLETE時request與frameSize (含檔名) 有效，檔名在data + REQUEST_SIZE
+	 * \param data 資料
+	 * \param size 資料大小
+	 * \param request 輸出的指令
+	 * \param frameSize 輸出的frame大小
+	 * \return 解析結果
+	 */
+	static BinaryFrameStatus ParseRequest(const unsigned char*, size_t, BinaryRequest&, size_t&);
+
+	/**
+	 * Intent : 把指令編碼成request frame (不含檔名)
+	 * Pre : data至少有REQUEST_SIZE個byte
+	 * Post :
+	 * \param request 指令
+	 * \param data 輸出的位置
+	 */
+	static void EncodeRequest(const BinaryRequest&, unsigned char*);
+
+	/**
+	 * Intent : 把回應編碼成response header
+	 * Pre : data至少有RESPONSE_SIZE個byte
+	 * Post :
+	 * \param response 回應
+	 * \param data 輸出的位置
+	 */
+	static void EncodeResponse(const BinaryResponse&, unsigned char*);
+
+	/**
+	 * Intent : 解析response header
+	 * Pre : data至少有RESPONSE_SIZE個byte
+	 * Post :
+	 * \param data 資料
+	 * \param response 輸出的回應
+	 */
+	static void DecodeResponse(const unsigned char*, BinaryResponse&);
+
+	/**
+	 * Intent : 把變更格子的位置編碼 (row col各8 byte)
+	 * Pre : data至少有CHANGE_SIZE個byte
+	 * Post :
+	 * \param change 變更格子的位置
+	 * \param data 輸出的位置
+	 */
+	static void EncodeChange(const CellChange&, unsigned char*);
+
+	/**
+	 * Intent : 解析變更格子的位置
+	 * Pre : data至少有CHANGE_SIZE個byte
+	 * Post :
+	 * \param data 資料
+	 * \param change 輸出的位置
+	 */
+	static void DecodeChange(const unsigned char*, CellChange&);
+
+	//frame開頭的magic byte，不是文字指令會出現的字元，可以用來分辨連線使用的協定
+	static const unsigned char MAGIC = 0xA5;
+
+	//flags : 有指定隨機種子、Print有指定範圍
+	static const std::uint8_t FLAG_SEED = 0x01;
+	static const std::uint8_t FLAG_RANGE = 0x02;
+
+	//request frame、response header與一個變更格子位置的大小
+	static const size_t REQUEST_SIZE = 56;
+	static const size_t RESPONSE_SIZE = 48;
+	static const size_t CHANGE_SIZE = 16;
+
+	//接在frame之後的檔名長度上限
+	static const long long MAX_PATH_SIZE = 4096;
+
+private:
+
+	/**
+	 * Intent : 以little-endian寫入整數
+	 * Pre :
+	 * Post :
+	 * \param data 輸出的位置
+	 * \param value 數值
+	 * \param size byte數
+	 */
+	static void Store(unsigned char*, std::uint64_t, int);
+
+	/**
+	 * Intent : 以little-endian讀取整數
+	 * Pre :
+	 * Post :
+	 * \param data 資料
+	 * \param size byte數
+	 * \return 數值
+	 */
+	static std::uint64_t Load(const unsigned char*, int);
+};
+
+#endif // !_BINARYPROTOCOLCORE_H_
@@ -0,0 +1,511 @@
+﻿/*****************************************************************//**
+ * File : BitBoardCore.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api implementation of MineSweeperExample
+ *********************************************************************/
+
+#include "BitBoardCore.h"
+
+using namespace std;
+
+//BitBoardCore constructor
+BitBoardCore::BitBoardCore()
+{
+
+}
+
+//BitBoardCore destructor
+BitBoardCore::~BitBoardCore()
+{
+
+}
+
+/**
+ * Intent : 由壓縮格子的byte資料建立所有平面
+ * Pre :
+ * Post : 建立完成
+ * \param bytes 第0列第0格的byte位置
+ * \param stride 一列在記憶體中的長度
+ * \param _rows row數量
+ * \param _cols col數量
+ */
+void BitBoardCore::Build(const unsigned char* bytes, int stride, int _rows, int _cols)
+{
+	rows = _rows;
+	cols = _cols;
+	byteStride = stride;
+	wordsPerRow = (cols + 63) / 64;
+
+	size_t planeSize = (size_t)(rows + 2) * wordsPerRow;
+	bombPlane.assign(planeSize, 0);
+	zeroPlane.assign(planeSize, 0);
+	openedPlane.assign(planeSize, 0);
+	flaggedPlane.assign(planeSize, 0);
+	questionPlane.assign(planeSize, 0);
+	reachPlane.assign(planeSize, 0);
+	rowQueued.assign(rows, 0);
+	rowTouched.assign(rows + 2, 0);
+	rowBuffer.assign(wordsPerRow, 0);
+	dilateBuffer.assign(wordsPerRow, 0);
+
+	const unsigned char openedBits = (unsigned char)CellState::OPENED << CellCore::STATE_SHIFT;
+	const unsigned char flaggedBits = (unsigned char)CellState::FLAGGED << CellCore::STATE_SHIFT;
+	const unsigned char questionBits = (unsigned char)CellState::QUESTION_MARK << CellCore::STATE_SHIFT;
+
+	for (int i = 0; i < rows; i++)
+	{
+		const unsigned char* row = bytes + (size_t)i * stride;
+		for (int j = 0; j < cols; j++)
+		{
+			size_t index = WordIndex(i, j >> 6);
+			std::uint64_t bit = (std::uint64_t)1 << (j & 63);
+			unsigned char cell = row[j];
+			unsigned char state = cell & CellCore::STATE_MASK;
+
+			if (cell & CellCore::BOMB_MASK)
+			{
+				bombPlane[index] |= bit;
+			}
+			else if ((cell & CellCore::COUNT_MASK) == 0)
+			{
+				zeroPlane[index] |= bit;
+			}
+
+			if (state == openedBits)
+			{
+				openedPlane[index] |= bit;
+			}
+			else if (state == flaggedBits)
+			{
+				flaggedPlane[index] |= bit;
+			}
+			else if (state == questionBits)
+			{
+				questionPlane[index] |= bit;
+			}
+		}
+	}
+}
+
+/**
+ * Intent : 釋放所有平面與buffer的記憶體 (一般情況下保留重複使用)
+ * Pre :
+ * Post : 需要重新Build才能使用
+ */
+void BitBoardCore::ShrinkMem()
+{
+	vector<std::uint64_t>().swap(bombPlane);
+	vector<std::uint64_t>().swap(zeroPlane);
+	vector<std::uint64_t>().swap(openedPlane);
+	vector<std::uint64_t>().swap(flaggedPlane);
+	vector<std::uint64_t>().swap(questionPlane);
+	vector<std::uint64_t>().swap(reachPlane);
+	vector<int>().swap(rowQueue);
+	vector<char>().swap(rowQueued);
+	vector<int>().swap(touchedRows);
+	vector<char>().swap(rowTouched);
+	vector<std::uint64_t>().swap(rowBuffer);
+	vector<std::uint64_t>().swap(dilateBuffer);
+	rows = 0;
+	cols = 0;
+	wordsPerRow = 0;
+}
+
+/**
+ * Intent : 回傳所有平面與buffer保留的記憶體大小 (含未使用的容量)
+ * Pre :
+ * Post :
+ * \return 保留的byte數
+ */
+size_t BitBoardCore::GetRetainedMemorySize() const
+{
+	size_t wordCount = bombPlane.capacity() + zeroPlane.capacity() + openedPlane.capacity() + flaggedPlane.capacity()
+		+ questionPlane.capacity() + reachPlane.capacity() + rowBuffer.capacity() + dilateBuffer.capacity();
+	return wordCount * sizeof(std::uint64_t) + (rowQueue.capacity() + touchedRows.capacity()) * sizeof(int)
+		+ rowQueued.capacity() + rowTouched.capacity();
+}
+
+/**
+ * Intent : 同步單一格子的顯示狀態 (更新已開啟、旗幟、問號平面)
+ * Pre : 已建立
+ * Post :
+ * \param row row位置
+ * \param col col位置
+ * \param state 新的格子顯示狀態
+ */
+void BitBoardCore::SetState(int row, int col, CellState state)
+{
+	size_t index = WordIndex(row, col >> 6);
+	std::uint64_t bit = (std::uint64_t)1 << (col & 63);
+
+	openedPlane[index] &= ~bit;
+	flaggedPlane[index] &= ~bit;
+	questionPlane[index] &= ~bit;
+
+	if (state == CellState::OPENED)
+	{
+		openedPlane[index] |= bit;
+	}
+	else if (state == CellState::FLAGGED)
+	{
+		flaggedPlane[index] |= bit;
+	}
+	else if (state == CellState::QUESTION_MARK)
+	{
+		questionPlane[index] |= bit;
+	}
+}
+
+/**
+ * Intent : 從指定格子開始，以逐列的bitwise膨脹運算開啟整個區域
+ * Pre : 已建立，該格可以被開啟且不是炸彈
+ * Post : 已開啟平面更新完成
+ * \param row row位置
+ * \param col col位置
+ * \param openedCells 輸出新開啟的格子相對於Build時第0列第0格的位置 (row * stride + col)，會先被清空
+ * \return 新開啟的格子數量 (以popcount計算)
+ */
+long long BitBoardCore::FloodOpen(int row, int col, std::vector<size_t>& openedCells)
+{
+	openedCells.clear();
+
+	size_t startIndex = WordIndex(row, col >> 6);
+	std::uint64_t startBit = (std::uint64_t)1 << (col & 63);
+	std::uint64_t startBlocked = bombPlane[startIndex] | openedPlane[startIndex] | flaggedPlane[startIndex];
+
+	//防呆機制
+	if (startBlocked & startBit)
+	{
+		return 0;
+	}
+
+	//不是0的格子只開啟自己
+	if (!(zeroPlane[startIndex] & startBit))
+	{
+		openedPlane[startIndex] |= startBit;
+		openedCells.push_back((size_t)row * byteStride + col);
+		return 1;
+	}
+
+	//第一階段 : 以列為單位反覆膨脹，找出與起點8方向相連、可開啟的0格子 (reachPlane)
+	reachPlane[startIndex] |= startBit;
+	minReachWord = col >> 6;
+	maxReachWord = col >> 6;
+	touchedRows.clear();
+	rowQueue.clear();
+	for (int nearRow = row - 1; nearRow <= row + 1; nearRow++)
+	{
+		QueueRow(nearRow);
+	}
+
+	while (!rowQueue.empty())
+	{
+		int currentRow = rowQueue.back();
+		rowQueue.pop_back();
+		rowQueued[currentRow] = 0;
+
+		//該列有新的0格子，上下兩列都可能因此擴張
+		if (ExpandRow(currentRow))
+		{
+			QueueRow(currentRow - 1);
+			QueueRow(currentRow + 1);
+		}
+	}
+
+	//第二階段 : 0格子本身與其周遭8格中可開啟的格子都要被開啟
+	//被碰過的列的上下一列也可能有要開啟的格子
+	size_t touchedCount = touchedRows.size();
+	for (size_t k = 0; k < touchedCount; k++)
+	{
+		for (int nearRow = touchedRows[k] - 1; nearRow <= touchedRows[k] + 1; nearRow += 2)
+		{
+			if (nearRow >= 0 && nearRow < rows && !rowTouched[nearRow + 1])
+			{
+				rowTouched[nearRow + 1] = 1;
+				touchedRows.push_back(nearRow);
+			}
+		}
+	}
+
+	//只需要處理可達格子所在的word範圍 (左右各多一個word)
+	int firstWord = max(minReachWord - 1, 0);
+	int lastWord = min(maxReachWord + 1, wordsPerRow - 1);
+
+	long long openedCount = 0;
+	for (int currentRow : touchedRows)
+	{
+		const std::uint64_t* up = &reachPlane[WordIndex(currentRow - 1, 0)];
+		const std::uint64_t* middle = &reachPlane[WordIndex(currentRow, 0)];
+		const std::uint64_t* down = &reachPlane[WordIndex(currentRow + 1, 0)];
+		for (int w = firstWord; w <= lastWord; w++)
+		{
+			rowBuffer[w] = up[w] | middle[w] | down[w];
+		}
+		DilateRow(&rowBuffer[0], &dilateBuffer[0], firstWord, lastWord);
+
+		size_t rowIndex = WordIndex(currentRow, 0);
+		for (int w = firstWord; w <= lastWord; w++)
+		{
+			size_t index = rowIndex + w;
+			std::uint64_t newlyOpened = dilateBuffer[w] & ~(bombPlane[index] | openedPlane[index] | flaggedPlane[index]);
+			if (w == wordsPerRow - 1 && (cols & 63) != 0)
+			{
+				newlyOpened &= ((std::uint64_t)1 << (cols & 63)) - 1;
+			}
+			if (newlyOpened == 0)
+			{
+				continue;
+			}
+
+			openedCount += PopCount(newlyOpened);
+
+			//開啟後問號標記會消失
+			openedPlane[index] |= newlyOpened;
+			questionPlane[index] &= ~newlyOpened;
+
+			//逐一取出最低位的bit，輸出新開啟的格子 (最低位bit的位置 = popcount(lowest - 1))
+			std::uint64_t bits = newlyOpened;
+			while (bits)
+			{
+				std::uint64_t lowest = bits & (0 - bits);
+				openedCells.push_back((size_t)currentRow * byteStride + ((size_t)w << 6) + PopCount(lowest - 1));
+				bits ^= lowest;
+			}
+		}
+	}
+
+	//清除這次用到的reachPlane與標記，下次重複使用
+	for (int currentRow : touchedRows)
+	{
+		size_t rowIndex = WordIndex(currentRow, 0);
+		for (int w = firstWord; w <= lastWord; w++)
+		{
+			reachPlane[rowIndex + w] = 0;
+		}
+		rowTouched[currentRow + 1] = 0;
+	}
+
+	return openedCount;
+}
+
+/**
+ * Intent : 計算一個word中為1的bit數量
+ * Pre :
+ * Post :
+ * \param value 輸入值
+ * \return 為1的bit數量
+ */
+int BitBoardCore::PopCount(std::uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcountll(value);
+#else
+	//SWAR popcount，不依賴特定指令集
+	value = value - ((value >> 1) & 0x5555555555555555ULL);
+	value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+	value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (int)((value * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/**
+ * Intent : 回傳第row列 (含上下的空白列，row可為-1與rows) 第word個word的位置
+ * Pre :
+ * Post :
+ * \param row row位置
+ * \param word word位置
+ * \return 在平面中的位置
+ */
+size_t BitBoardCore::WordIndex(int row, int word)
+{
+	return (size_t)(row + 1) * wordsPerRow + word;
+}
+
+/**
+ * Intent : 計算一列在[firstWord, lastWord]範圍內的水平膨脹 (自己與左右各一格)
+ * Pre : 範圍外的bit都是0
+ * Post :
+ * \param source 輸入的列
+ * \param output 輸出的列
+ * \param firstWord 範圍的第一個word
+ * \param lastWord 範圍的最後一個word
+ */
+void BitBoardCore::DilateRow(const std::uint64_t* source, std::uint64_t* output, int firstWord, int lastWord)
+{
+	for (int w = firstWord; w <= lastWord; w++)
+	{
+		std::uint64_t left = source[w] << 1;
+		std::uint64_t right = source[w] >> 1;
+
+		//跨word的進位
+		if (w > firstWord)
+		{
+			left |= source[w - 1] >> 63;
+		}
+		if (w < lastWord)
+		{
+			right |= source[w + 1] << 63;
+		}
+		output[w] = source[w] | left | right;
+	}
+}
+
+/**
+ * Intent : 將目前列的可達0格子擴張到穩定，上下列的可達格子也會被考慮
+ * Pre :
+ * Post : 可達格子所在的word範圍同步更新
+ * \param row row位置
+ * \return 該列是否有改變
+ */
+bool BitBoardCore::ExpandRow(int row)
+{
+	size_t rowIndex = WordIndex(row, 0);
+	const std::uint64_t* up = &reachPlane[WordIndex(row - 1, 0)];
+	const std::uint64_t* down = &reachPlane[WordIndex(row + 1, 0)];
+	std::uint64_t* middle = &reachPlane[rowIndex];
+
+	//本列可擴張的0格子 (含已到達的格子)
+	auto expandableMask = [&](int w)
+	{
+		size_t index = rowIndex + w;
+		return (zeroPlane[index] & ~(openedPlane[index] | flaggedPlane[index])) | middle[w];
+	};
+
+	//上下列的可達格子只在目前的word範圍內，左右各多一個word就足夠
+	int firstWord = max(minReachWord - 1, 0);
+	int lastWord = min(maxReachWord + 1, wordsPerRow - 1);
+
+	//上中下三列的可達格子做水平膨脹後，與本列可擴張的0格子取交集
+	for (int w = firstWord; w <= lastWord; w++)
+	{
+		rowBuffer[w] = up[w] | middle[w] | down[w];
+	}
+	DilateRow(&rowBuffer[0], &dilateBuffer[0], firstWord, lastWord);
+
+	for (int w = firstWord; w <= lastWord; w++)
+	{
+		rowBuffer[w] = expandableMask(w);
+		dilateBuffer[w] = middle[w] | (dilateBuffer[w] & rowBuffer[w]);
+	}
+
+	//同一列內沿著連續的0格子填滿 : 先由低位往高位、再由高位往低位各掃一次
+	//連續的0格子延伸到範圍外時，繼續往外掃到中斷為止
+	for (int w = firstWord; w <= lastWord; w++)
+	{
+		if (w > firstWord && (dilateBuffer[w - 1] >> 63))
+		{
+			dilateBuffer[w] |= rowBuffer[w] & 1;
+		}
+		dilateBuffer[w] = FillUp(dilateBuffer[w], rowBuffer[w]);
+	}
+	while (lastWord + 1 < wordsPerRow && (dilateBuffer[lastWord] >> 63))
+	{
+		lastWord++;
+		rowBuffer[lastWord] = expandableMask(lastWord);
+		dilateBuffer[lastWord] = FillUp(middle[lastWord] | (rowBuffer[lastWord] & 1), rowBuffer[lastWord]);
+	}
+
+	for (int w = lastWord; w >= firstWord; w--)
+	{
+		if (w < lastWord && (dilateBuffer[w + 1] & 1))
+		{
+			dilateBuffer[w] |= rowBuffer[w] & ((std::uint64_t)1 << 63);
+		}
+		dilateBuffer[w] = FillDown(dilateBuffer[w], rowBuffer[w]);
+	}
+	while (firstWord > 0 && (dilateBuffer[firstWord] & 1))
+	{
+		firstWord--;
+		rowBuffer[firstWord] = expandableMask(firstWord);
+		dilateBuffer[firstWord] = FillDown(middle[firstWord] | (rowBuffer[firstWord] & ((std::uint64_t)1 << 63)), rowBuffer[firstWord]);
+	}
+
+	bool changed = false;
+	for (int w = firstWord; w <= lastWord; w++)
+	{
+		if (dilateBuffer[w] != middle[w])
+		{
+			middle[w] = dilateBuffer[w];
+			changed = true;
+
+			minReachWord = min(minReachWord, w);
+			maxReachWord = max(maxReachWord, w);
+		}
+	}
+	return changed;
+}
+
+/**
+ * Intent : 把該列放入工作佇列，並記錄為碰過的列
+ * Pre :
+ * Post :
+ * \param row row位置 (超出範圍時忽略)
+ */
+void BitBoardCore::QueueRow(int row)
+{
+	if (row < 0 || row >= rows)
+	{
+		return;
+	}
+	if (!rowTouched[row + 1])
+	{
+		rowTouched[row + 1] = 1;
+		touchedRows.push_back(row);
+	}
+	if (!rowQueued[row])
+	{
+		rowQueued[row] = 1;
+		rowQueue.push_back(row);
+	}
+}
+
+/**
+ * Intent : 在mask的範圍內，把seed沿著連續的1往高位填滿 (Kogge-Stone，6步完成64bit)
+ * Pre : seed包含於mask
+ * Post :
+ * \param seed 起始的bit
+ * \param mask 可以填的範圍
+ * \return 填滿後的結果
+ */
+std::uint64_t BitBoardCore::FillUp(std::uint64_t seed, std::uint64_t mask)
+{
+	seed |= mask & (seed << 1);
+	mask &= mask << 1;
+	seed |= mask & (seed << 2);
+	mask &= mask << 2;
+	seed |= mask & (seed << 4);
+	mask &= mask << 4;
+	seed |= mask & (seed << 8);
+	mask &= mask << 8;
+	seed |= mask & (seed << 16);
+	mask &= mask << 16;
+	seed |= mask & (seed << 32);
+	return seed;
+}
+
+/**
+ * Intent : 在mask的範圍內，把seed沿著連續的1往低位填滿 (Kogge-Stone，6步完成64bit)
+ * Pre : seed包含於mask
+ * Post :
+ * \param seed 起始的bit
+ * \param mask 可以填的範圍
+ * \return 填滿後的結果
+ */
+std::uint64_t BitBoardCore::FillDown(std::uint64_t seed, std::uint64_t mask)
+{
+	seed |= mask & (seed >> 1);
+	mask &= mask >> 1;
+	seed |= mask & (seed >> 2);
+	mask &= mask >> 2;
+	seed |= mask & (seed >> 4);
+	mask &= mask >> 4;
+	seed |= mask & (seed >> 8);
+	mask &= mask >> 8;
+	seed |= mask & (seed >> 16);
+	mask &= mask >> 16;
+	seed |= mask & (seed >> 32);
+	return seed;
+}
@@ -0,0 +1,183 @@
+﻿/*****************************************************************//**
+ * File : BitBoardCore.h
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api header of MineSweeperExample
+ *********************************************************************/
+
+#pragma once
+#ifndef _BITBOARDCORE_H_
+#define _BITBOARDCORE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "CellCore.h"
+
+//用64bit的bitboard表示盤面，每個bit代表一格，一個word一次處理64格
+//包含炸彈、0、已開啟、旗幟、問號等平面，上下各多一列全為0的列，方便做膨脹運算
+class BitBoardCore
+{
+public:
+
+	//BitBoardCore constructor
+	BitBoardCore();
+
+	//BitBoardCore destructor
+	~BitBoardCore();
+
+	/**
+	 * Intent : 由壓縮格子的byte資料建立所有平面
+	 * Pre :
+	 * Post : 建立完成
+	 * \param bytes 第0列第0格的byte位置
+	 * \param stride 一列在記憶體中的長度
+	 * \param _rows row數量
+	 * \param _cols col數量
+	 */
+	void Build(const unsigned char*, int, int, int);
+
+	/**
+	 * Intent : 釋放所有平面與buffer的記憶體 (一般情況下保留重複使用)
+	 * Pre :
+	 * Post : 需要重新Build才能使用
+	 */
+	void ShrinkMem();
+
+	/**
+	 * Intent : 回傳所有平面與buffer保留的記憶體大小 (含未使用的容量)
+	 * Pre :
+	 * Post :
+	 * \return 保留的byte數
+	 */
+	size_t GetRetainedMemorySize() const;
+
+	/**
+	 * Intent : 同步單一格子的顯示狀態 (更新已開啟、旗幟、問號平面)
+	 * Pre : 已建立
+	 * Post :
+	 * \param row row位置
+	 * \param col col位置
+	 * \param state 新的格子顯示狀態
+	 */
+	void SetState(int, int, CellState);
+
+	/**
+	 * Intent : 從指定格子開始，以逐列的bitwise膨脹運算開啟整個區域
+	 * Pre : 已建立，該格可以被開啟且不是炸彈
+	 * Post : 已開啟平面更新完成
+	 * \param row row位置
+	 * \param col col位置
+	 * \param openedCells 輸出新開啟的格子相對於Build時第0列第0格的位置 (row * stride + col)，會先被清空
+	 * \return 新開啟的格子數量 (以popcount計算)
+	 */
+	long long FloodOpen(int, int, std::vector<size_t>&);
+
+	/**
+	 * Intent : 計算一個word中為1的bit數量
+	 * Pre :
+	 * Post :
+	 * \param value 輸入值
+	 * \return 為1的bit數量
+	 */
+	static int PopCount(std::uint64_t);
+
+private:
+
+	/**
+	 * Intent : 回傳第row列 (含上下的空白列，row可為-1與rows) 第word個word的位置
+	 * Pre :
+	 * Post :
+	 * \param row row位置
+	 * \param word word位置
+	 * \return 在平面中的位置
+	 */
+	size_t WordIndex(int, int);
+
+	/**
+	 * Intent : 計算一列在[firstWord, lastWord]範圍內的水平膨脹 (自己與左右各一格)
+	 * Pre : 範圍外的bit都是0
+	 * Post :
+	 * \param source 輸入的列
+	 * \param output 輸出的列
+	 * \param firstWord 範圍的第一個word
+	 * \param lastWord 範圍的最後一個word
+	 */
+	void DilateRow(const std::uint64_t*, std::uint64_t*, int, int);
+
+	/**
+	 * Intent : 將目前列的可達0格子擴張到穩定，上下列的可達格子也會被考慮
+	 * Pre :
+	 * Post : 可達格子所在的word範圍同步更新
+	 * \param row row位置
+	 * \return 該列是否有改變
+	 */
+	bool ExpandRow(int);
+
+	/**
+	 * Intent : 把該列放入工作佇列，並記錄為碰過的列
+	 * Pre :
+	 * Post :
+	 * \param row row位置 (超出範圍時忽略)
+	 */
+	void QueueRow(int);
+
+	/**
+	 * Intent : 在mask的範圍內，把seed沿著連續的1往高位填滿 (Kogge-Stone，6步完成64bit)
+	 * Pre : seed包含於mask
+	 * Post :
+	 * \param seed 起始的bit
+	 * \param mask 可以填的範圍
+	 * \return 填滿後的結果
+	 */
+	static std::uint64_t FillUp(std::uint64_t, std::uint64_t);
+
+	/**
+	 * Intent : 在mask的範圍內，把seed沿著連續的1往低位填滿 (Kogge-Stone，6步完成64bit)
+	 * Pre : seed包含於mask
+	 * Post :
+	 * \param seed 起始的bit
+	 * \param mask 可以填的範圍
+	 * \return 填滿後的結果
+	 */
+	static std::uint64_t FillDown(std::uint64_t, std::uint64_t);
+
+	//row col 數量與每列的word數量
+	int rows = 0;
+	int cols = 0;
+	int wordsPerRow = 0;
+
+	//Build時一列在記憶體中的長度，輸出開啟的格子位置時使用
+	int byteStride = 0;
+
+	//各平面
+	std::vector<std::uint64_t> bombPlane;
+	std::vector<std::uint64_t> zeroPlane;
+	std::vector<std::uint64_t> openedPlane;
+	std::vector<std::uint64_t> flaggedPlane;
+	std::vector<std::uint64_t> questionPlane;
+
+	//flood fill時已到達的0格子平面，只有被碰過的列會被清除，重複使用
+	std::vector<std::uint64_t> reachPlane;
+
+	//flood fill時可達格子所在的word範圍，每列只處理這個範圍，寬盤面上的小區域不必掃過整列
+	int minReachWord = 0;
+	int maxReachWord = 0;
+
+	//flood fill的工作列佇列與是否已在佇列中
+	std::vector<int> rowQueue;
+	std::vector<char> rowQueued;
+
+	//flood fill碰過的列
+	std::vector<int> touchedRows;
+	std::vector<char> rowTouched;
+
+	//單列運算用的暫存buffer
+	std::vector<std::uint64_t> rowBuffer;
+	std::vector<std::uint64_t> dilateBuffer;
+};
+
+#endif // !_BITBOARDCORE_H_
@@ -0,0 +1,227 @@
+﻿/*****************************************************************//**
+ * File : BoardCacheCore.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api implementation of MineSweeperExample
+ *********************************************************************/
+
+#include "BoardCacheCore.h"
+
+#include <sys/stat.h>
+
+using namespace std;
+
+//BoardCacheCore constructor
+BoardCacheCore::BoardCacheCore(std::uint64_t _memoryLimit) : memoryLimit(_memoryLimit)
+{
+
+}
+
+/**
+ * Intent : 獲取全域共用的盤面快取
+ * Pre :
+ * Post :
+ * \return 全域共用的盤面快取
+ */
+BoardCacheCore& BoardCacheCore::Instance()
+{
+	static BoardCacheCore cache(DEFAULT_MEMORY_LIMIT);
+	return cache;
+}
+
+/**
+ * Intent : 讀取檔案的大小與修改時間
+ * Pre :
+ * Post :
+ * \param filename 檔案名稱
+ * \param stamp 輸出的大小與修改時間
+ * \return 是否成功 (檔案不存在時失敗)
+ */
+bool BoardCacheCore::GetFileStamp(const std::string& filename, FileStamp& stamp)
+{
+#ifdef _WIN32
+	struct _stat64 info;
+	if (_stat64(filename.c_str(), &info) != 0)
+	{
+		return false;
+	}
+	stamp.size = (std::uint64_t)info.st_size;
+	stamp.modifyTime = (std::int64_t)info.st_mtime;
+#else
+	struct stat info;
+	if (stat(filename.c_str(), &info) != 0)
+	{
+		return false;
+	}
+
+	//修改時間使用奈秒，同一秒內被覆寫的檔案也能分辨
+	stamp.size = (std::uint64_t)info.st_size;
+#ifdef __APPLE__
+	stamp.modifyTime = (std::int64_t)info.st_mtimespec.tv_sec * 1000000000LL + info.st_mtimespec.tv_nsec;
+#else
+	stamp.modifyTime = (std::int64_t)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+#endif
+#endif
+	return true;
+}
+
+/**
+ * Intent : 由快取載入盤面，命中時把盤面移到最近使用的位置，過期的盤面會被移除
+ * Pre :
+ * Post : 命中時board載入完成，複製在釋放lock之後進行
+ * \param filename 盤面檔檔名
+ * \param stamp 盤面檔目前的大小與修改時間
+ * \param board 要載入的盤面
+ * \param seed 輸出盤面檔中的種子
+ * \return 是否命中
+ */
+bool BoardCacheCore::Fetch(const std::string& filename, const FileStamp& stamp, BoardCore& board, std::uint64_t& seed)
+{
+	shared_ptr<const BoardCore> cachedBoard;
+	{
+		lock_guard<mutex> lock(cacheMutex);
+
+		auto found = entryMap.find(filename);
+		if (found == entryMap.end())
+		{
+			missCount++;
+			return false;
+		}
+
+		//檔案已被修改，快取的盤面不能再使用
+		if (!(found->second->stamp == stamp))
+		{
+			Erase(found->second);
+			missCount++;
+			return false;
+		}
+
+		entries.splice(entries.begin(), entries, found->second);
+		cachedBoard = found->second->board;
+		seed = found->second->seed;
+		hitCount++;
+	}
+
+	//整個盤面的複製在lock外進行，其他執行緒的載入不需要等待
+	board.CopyFrom(*cachedBoard);
+	return true;
+}
+
+/**
+ * Intent : 把剛解析好的盤面複製一份存進快取，超過記憶體上限時移除最久沒有使用的盤面
+ * Pre : board已載入且還沒有開啟任何格子，stamp為開檔前讀取的大小與修改時間
+ * Post : 盤面大於記憶體上限時不存入，複製在取得lock之前進行
+ * \param filename 盤面檔檔名
+ * \param stamp 盤面檔的大小與修改時間
+ * \param board 剛解析好的盤面
+ * \param seed 盤面檔中的種子
+ */
+void BoardCacheCore::Store(const std::string& filename, const FileStamp& stamp, const BoardCore& board, std::uint64_t seed)
+{
+	std::uint64_t boardSize = board.GetMemorySize();
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		if (boardSize == 0 || boardSize > memoryLimit)
+		{
+			return;
+		}
+	}
+
+	//整個盤面的複製在lock外進行
+	shared_ptr<BoardCore> cachedBoard = make_shared<BoardCore>();
+	cachedBoard->CopyFrom(board);
+
+	lock_guard<mutex> lock(cacheMutex);
+
+	//複製期間上限可能已被調低
+	if (boardSize > memoryLimit)
+	{
+		return;
+	}
+
+	//同一個檔名只保留最新的盤面
+	auto found = entryMap.find(filename);
+	if (found != entryMap.end())
+	{
+		Erase(found->second);
+	}
+	EvictTo(memoryLimit - boardSize);
+
+	entries.emplace_front();
+	Entry& entry = entries.front();
+	entry.filename = filename;
+	entry.stamp = stamp;
+	entry.seed = seed;
+	entry.board = move(cachedBoard);
+	entryMap[filename] = entries.begin();
+	memoryUsed += boardSize;
+}
+
+/**
+ * Intent : 設定快取的記憶體上限，0代表停用快取 (整個程序共用，由啟動參數設定)
+ * Pre :
+ * Post : 超過新上限的盤面會被移除
+ * \param limit 記憶體上限 (byte)
+ */
+void BoardCacheCore::SetMemoryLimit(std::uint64_t limit)
+{
+	lock_guard<mutex> lock(cacheMutex);
+	memoryLimit = limit;
+	EvictTo(memoryLimit);
+}
+
+/**
+ * Intent : 移除所有快取的盤面 (命中/未命中次數保留)
+ * Pre :
+ * Post :
+ */
+void BoardCacheCore::Clear()
+{
+	lock_guard<mutex> lock(cacheMutex);
+	entries.clear();
+	entryMap.clear();
+	memoryUsed = 0;
+}
+
+/**
+ * Intent : 回傳快取狀態的字串 "Hits h Misses m Evictions e Entries n Bytes b Limit l"
+ * Pre :
+ * Post :
+ * \return 快取狀態的字串
+ */
+std::string BoardCacheCore::GetStatus()
+{
+	lock_guard<mutex> lock(cacheMutex);
+	return "Hits " + to_string(hitCount) + " Misses " + to_string(missCount) + " Evictions " + to_string(evictionCount)
+		+ " Entries " + to_string(entries.size()) + " Bytes " + to_string(memoryUsed) + " Limit " + to_string(memoryLimit);
+}
+
+/**
+ * Intent : 移除一個快取的盤面
+ * Pre : 已持有lock
+ * Post :
+ * \param entry 要移除的盤面
+ */
+void BoardCacheCore::Erase(std::list<Entry>::iterator entry)
+{
+	memoryUsed -= entry->board->GetMemorySize();
+	entryMap.erase(entry->filename);
+	entries.erase(entry);
+}
+
+/**
+ * Intent : 由最久沒有使用的盤面開始移除，直到使用量不超過上限
+ * Pre : 已持有lock
+ * Post :
+ * \param limit 使用量的上限
+ */
+void BoardCacheCore::EvictTo(std::uint64_t limit)
+{
+	while (memoryUsed > limit && !entries.empty())
+	{
+		Erase(prev(entries.end()));
+		evictionCount++;
+	}
+}
@@ -0,0 +1,158 @@
+﻿/*****************************************************************//**
+ * File : BoardCacheCore.h
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api header of MineSweeperExample
+ *********************************************************************/
+
+#pragma once
+#ifndef _BOARDCACHECORE_H_
+#define _BOARDCACHECORE_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "BoardCore.h"
+
+//已解析並計算好數字的盤面檔快取 (LRU)，以 (檔案路徑, 檔案大小, 修改時間) 為key
+//重複載入同一個盤面檔時直接複製快取中的格子記憶體，不需要重新開檔、解析與計算數字
+//全域共用，可以被多個執行緒同時存取，盤面的複製不在lock內進行
+class BoardCacheCore
+{
+public:
+
+	//檔案的大小與修改時間，任一個改變就代表快取已過期
+	struct FileStamp
+	{
+		std::uint64_t size = 0;
+		std::int64_t modifyTime = 0;
+
+		bool operator==(const FileStamp& other) const
+		{
+			return size == other.size && modifyTime == other.modifyTime;
+		}
+	};
+
+	//BoardCacheCore constructor
+	BoardCacheCore(std::uint64_t);
+
+	/**
+	 * Intent : 獲取全域共用的盤面快取
+	 * Pre :
+	 * Post :
+	 * \return 全域共用的盤面快取
+	 */
+	static BoardCacheCore& Instance();
+
+	/**
+	 * Intent : 讀取檔案的大小與修改時間
+	 * Pre :
+	 * Post :
+	 * \param filename 檔案名稱
+	 * \param stamp 輸出的大小與修改時間
+	 * \return 是否成功 (檔案不存在時失敗)
+	 */
+	static bool GetFileStamp(const std::string&, FileStamp&);
+
+	/**
+	 * Intent : 由快取載入盤面，命中時把盤面移到最近使用的位置，過期的盤面會被移除
+	 * Pre :
+	 * Post : 命中時board載入完成，複製在釋放lock之後進行
+	 * \param filename 盤面檔檔名
+	 * \param stamp 盤面檔目前的大小與修改時間
+	 * \param board 要載入的盤面
+	 * \param seed 輸出盤面檔中的種子
+	 * \return 是否命中
+	 */
+	bool Fetch(const std::string&, const FileStamp&, BoardCore&, std::uint64_t&);
+
+	/**
+	 * Intent : 把剛解析好的盤面複製一份存進快取，超過記憶體上限時移除最久沒有使用的盤面
+	 * Pre : board已載入且還沒有開啟任何格子，stamp為開檔前讀取的大小與修改時間
+	 * Post : 盤面大於記憶體上限時不存入，複製在取得lock之前進行
+	 * \param filename 盤面檔檔名
+	 * \param stamp 盤面檔的大小與修改時間
+	 * \param board 剛解析好的盤面
+	 * \param seed 盤面檔中的種子
+	 */
+	void Store(const std::string&, const FileStamp&, const BoardCore&, std::uint64_t);
+
+	/**
+	 * Intent : 設定快取的記憶體上限，0代表停用快取 (整個程序共用，由啟動參數設定)
+	 * Pre :
+	 * Post : 超過新上限的盤面會被移除
+	 * \param limit 記憶體上限 (byte)
+	 */
+	void SetMemoryLimit(std::uint64_t);
+
+	/**
+	 * Intent : 移除所有快取的盤面 (命中/未命中次數保留)
+	 * Pre :
+	 * Post :
+	 */
+	void Clear();
+
+	/**
+	 * Intent : 回傳快取狀態的字串 "Hits h Misses m Evictions e Entries n Bytes b Limit l"
+	 * Pre :
+	 * Post :
+	 * \return 快取狀態的字串
+	 */
+	std::string GetStatus();
+
+	//預設的記憶體上限
+	static const std::uint64_t DEFAULT_MEMORY_LIMIT = 256ULL << 20;
+
+private:
+
+	//一個快取的盤面，盤面本身以shared_ptr共用，被移除時正在複製的執行緒仍可安全讀取
+	struct Entry
+	{
+		std::string filename;
+		FileStamp stamp;
+		std::uint64_t seed = 0;
+		std::shared_ptr<const BoardCore> board;
+	};
+
+	/**
+	 * Intent : 移除一個快取的盤面
+	 * Pre : 已持有lock
+	 * Post :
+	 * \param entry 要移除的盤面
+	 */
+	void Erase(std::list<Entry>::iterator);
+
+	/**
+	 * Intent : 由最久沒有使用的盤面開始移除，直到使用量不超過上限
+	 * Pre : 已持有lock
+	 * Post :
+	 * \param limit 使用量的上限
+	 */
+	void EvictTo(std::uint64_t);
+
+	//快取的盤面，越前面越近期使用
+	std::list<Entry> entries;
+
+	//檔名對應到快取的盤面
+	std::unordered_map<std::string, std::list<Entry>::iterator> entryMap;
+
+	//記憶體上限與目前的使用量
+	std::uint64_t memoryLimit = 0;
+	std::uint64_t memoryUsed = 0;
+
+	//統計數字
+	std::uint64_t hitCount = 0;
+	std::uint64_t missCount = 0;
+	std::uint64_t evictionCount = 0;
+
+	//保護以上所有成員
+	std::mutex cacheMutex;
+};
+
+#endif // !_BOARDCACHECORE_H_
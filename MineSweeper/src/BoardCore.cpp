@@ -9,8 +9,165 @@
 
 #include "BoardCore.h"
 
+#include <array>
+
+//依照編譯目標選擇SIMD指令集，都不支援時使用純量版本
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BOARDCORE_USE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BOARDCORE_USE_SSE2
+#endif
+
 using namespace std;
 
+/**
+ * Intent : 計算一整列每格左中右3格的炸彈數量 (box filter的水平方向)
+ * Pre : row[-1]與row[count]可以讀取 (哨兵格子)
+ * Post :
+ * \param row 該列第一個格子的byte位置
+ * \param out 輸出的水平炸彈數量
+ * \param count 格子數量
+ */
+static void HorizontalBombSum(const unsigned char* row, unsigned char* out, int count)
+{
+	int j = 0;
+#if defined(BOARDCORE_USE_AVX2)
+	const __m256i bombMask = _mm256_set1_epi8(CellCore::BOMB_MASK);
+	for (; j + 32 <= count; j += 32)
+	{
+		__m256i left = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(row + j - 1)), bombMask);
+		__m256i center = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(row + j)), bombMask);
+		__m256i right = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(row + j + 1)), bombMask);
+		_mm256_storeu_si256((__m256i*)(out + j), _mm256_add_epi8(_mm256_add_epi8(left, center), right));
+	}
+#elif defined(BOARDCORE_USE_SSE2)
+	const __m128i bombMask = _mm_set1_epi8(CellCore::BOMB_MASK);
+	for (; j + 16 <= count; j += 16)
+	{
+		__m128i left = _mm_and_si128(_mm_loadu_si128((const __m128i*)(row + j - 1)), bombMask);
+		__m128i center = _mm_and_si128(_mm_loadu_si128((const __m128i*)(row + j)), bombMask);
+		__m128i right = _mm_and_si128(_mm_loadu_si128((const __m128i*)(row + j + 1)), bombMask);
+		_mm_storeu_si128((__m128i*)(out + j), _mm_add_epi8(_mm_add_epi8(left, center), right));
+	}
+#endif
+	//剩下不足一個向量長度的格子
+	for (; j < count; j++)
+	{
+		out[j] = (row[j - 1] & CellCore::BOMB_MASK) + (row[j] & CellCore::BOMB_MASK) + (row[j + 1] & CellCore::BOMB_MASK);
+	}
+}
+
+/**
+ * Intent : 把上中下3列的水平炸彈數量相加 (box filter的垂直方向)，扣掉自己後寫入每格的near bomb count
+ * Pre :
+ * Post : 該列每格的near bomb count更新完成
+ * \param row 該列第一個格子的byte位置
+ * \param up 上一列的水平炸彈數量
+ * \param middle 該列的水平炸彈數量
+ * \param down 下一列的水平炸彈數量
+ * \param count 格子數量
+ */
+static void StoreNearBombCount(unsigned char* row, const unsigned char* up, const unsigned char* middle, const unsigned char* down, int count)
+{
+	int j = 0;
+#if defined(BOARDCORE_USE_AVX2)
+	const __m256i bombMask = _mm256_set1_epi8(CellCore::BOMB_MASK);
+	const __m256i countMask = _mm256_set1_epi8(CellCore::COUNT_MASK);
+	for (; j + 32 <= count; j += 32)
+	{
+		__m256i cell = _mm256_loadu_si256((const __m256i*)(row + j));
+		__m256i sum = _mm256_add_epi8(_mm256_loadu_si256((const __m256i*)(up + j)), _mm256_loadu_si256((const __m256i*)(middle + j)));
+		sum = _mm256_add_epi8(sum, _mm256_loadu_si256((const __m256i*)(down + j)));
+		sum = _mm256_sub_epi8(sum, _mm256_and_si256(cell, bombMask));
+
+		//數量最多為8，以16bit為單位左移也不會溢位到相鄰的byte
+		__m256i shifted = _mm256_and_si256(_mm256_slli_epi16(sum, CellCore::COUNT_SHIFT), countMask);
+		_mm256_storeu_si256((__m256i*)(row + j), _mm256_or_si256(_mm256_andnot_si256(countMask, cell), shifted));
+	}
+#elif defined(BOARDCORE_USE_SSE2)
+	const __m128i bombMask = _mm_set1_epi8(CellCore::BOMB_MASK);
+	const __m128i countMask = _mm_set1_epi8(CellCore::COUNT_MASK);
+	for (; j + 16 <= count; j += 16)
+	{
+		__m128i cell = _mm_loadu_si128((const __m128i*)(row + j));
+		__m128i sum = _mm_add_epi8(_mm_loadu_si128((const __m128i*)(up + j)), _mm_loadu_si128((const __m128i*)(middle + j)));
+		sum = _mm_add_epi8(sum, _mm_loadu_si128((const __m128i*)(down + j)));
+		sum = _mm_sub_epi8(sum, _mm_and_si128(cell, bombMask));
+
+		//數量最多為8，以16bit為單位左移也不會溢位到相鄰的byte
+		__m128i shifted = _mm_and_si128(_mm_slli_epi16(sum, CellCore::COUNT_SHIFT), countMask);
+		_mm_storeu_si128((__m128i*)(row + j), _mm_or_si128(_mm_andnot_si128(countMask, cell), shifted));
+	}
+#endif
+	//剩下不足一個向量長度的格子
+	for (; j < count; j++)
+	{
+		int sum = up[j] + middle[j] + down[j] - (row[j] & CellCore::BOMB_MASK);
+		row[j] = (row[j] & ~CellCore::COUNT_MASK) | (unsigned char)(sum << CellCore::COUNT_SHIFT);
+	}
+}
+
+/**
+ * Intent : 把一列的炸彈平面與數字平面展開成格子的byte (顯示狀態為關閉)
+ *          以查表一次展開8格 : 炸彈平面的1個byte -> 8格的炸彈bit，數字平面的4個byte -> 8格的數字
+ * Pre : 平面格式與BoardCore::LoadPlanes相同，little-endian
+ * Post :
+ * \param row 該列第一個格子的byte位置
+ * \param bombRow 該列的炸彈平面
+ * \param countRow 該列的數字平面 (可為nullptr)
+ * \param count 格子數量
+ */
+static void ExpandPlaneRow(unsigned char* row, const std::uint64_t* bombRow, const unsigned char* countRow, int count)
+{
+	//第k個bit放到第k個byte的最低位
+	static const std::array<std::uint64_t, 256> bombSpread = []()
+	{
+		std::array<std::uint64_t, 256> table = {};
+		for (int bits = 0; bits < 256; bits++)
+		{
+			for (int k = 0; k < 8; k++)
+			{
+				table[bits] |= (std::uint64_t)((bits >> k) & 1) << (k * 8);
+			}
+		}
+		return table;
+	}();
+
+	//1個byte的兩個4bit數字放到相鄰兩格的數字欄位
+	static const std::array<std::uint64_t, 256> countPair = []()
+	{
+		std::array<std::uint64_t, 256> table = {};
+		for (int value = 0; value < 256; value++)
+		{
+			table[value] = (std::uint64_t)((value & 0x0F) << CellCore::COUNT_SHIFT)
+				| ((std::uint64_t)((value >> 4) << CellCore::COUNT_SHIFT) << 8);
+		}
+		return table;
+	}();
+
+	const unsigned char* bombBytes = reinterpret_cast<const unsigned char*>(bombRow);
+	int j = 0;
+	for (; j + 8 <= count; j += 8)
+	{
+		std::uint64_t eightCells = bombSpread[bombBytes[j >> 3]];
+		if (countRow != nullptr)
+		{
+			const unsigned char* counts = countRow + (j >> 1);
+			eightCells |= countPair[counts[0]] | (countPair[counts[1]] << 16) | (countPair[counts[2]] << 32) | (countPair[counts[3]] << 48);
+		}
+		memcpy(row + j, &eightCells, 8);
+	}
+
+	//剩下不足8格的格子
+	for (; j < count; j++)
+	{
+		unsigned char nearBombCount = countRow != nullptr ? (countRow[j >> 1] >> ((j & 1) * 4)) & 0x0F : 0;
+		row[j] = (unsigned char)((bombRow[j >> 6] >> (j & 63)) & 1) | (unsigned char)(nearBombCount << CellCore::COUNT_SHIFT);
+	}
+}
+
 //BoardCore constructor
 BoardCore::BoardCore()
 {
@@ -26,14 +183,12 @@ BoardCore::BoardCore(int _rows, int _cols) : rows(_rows), cols(_cols)
 //BoardCore destructor
 BoardCore::~BoardCore()
 {
-	if (cells != nullptr)
-	{
-		Clear();
-	}
+	delete[] cells;
+	cells = nullptr;
 }
 
 /**
- * Intent : 重新配置2維陣列記憶體
+ * Intent : 重新配置盤面記憶體 (一次配置，外圍含一圈哨兵格子)
  * Pre :
  * Post : 配置完成
  * \param _rows row數量
@@ -47,19 +202,54 @@ void BoardCore::AllocateMem(int _rows, int _cols)
 		return;
 	}
 
-	//如果已經配置過記憶體了，先釋放掉
-	if (cells != nullptr)
+	//如果已經載入過盤面了，先清除
+	if (loaded)
 	{
-		//釋放記憶體
 		Clear();
 	}
 
-	//配置2維陣列記憶體
-	cells = new CellCore * [_rows];
+	//配置一整塊連續記憶體 (row-major)，外圍多留一圈哨兵格子
+	//哨兵格子不是炸彈且為開啟狀態，計算周遭炸彈數與flood fill時都不需要再檢查邊界
+	//Clear不釋放記憶體，盤面不比以往載入過的大時直接重複使用，只需要把格子改回預設值
+	int paddedRows = _rows + 2;
+	int paddedCols = _cols + 2;
+	size_t cellCount = (size_t)paddedRows * paddedCols;
+	if (cellCount > cellCapacity)
+	{
+		delete[] cells;
+		cells = new CellCore[cellCount];
+		cellCapacity = cellCount;
+	}
+	else
+	{
+		memset(reinterpret_cast<unsigned char*>(cells), 0, cellCount * sizeof(CellCore));
+	}
+	stride = paddedCols;
+	loaded = true;
+
+	for (int j = 0; j < paddedCols; j++)
+	{
+		cells[j].SetState(CellState::OPENED);
+		cells[(size_t)(paddedRows - 1) * paddedCols + j].SetState(CellState::OPENED);
+	}
+	for (int i = 1; i < paddedRows - 1; i++)
+	{
+		cells[(size_t)i * paddedCols].SetState(CellState::OPENED);
+		cells[(size_t)i * paddedCols + paddedCols - 1].SetState(CellState::OPENED);
+	}
 
-	for (int i = 0; i < _rows; i++)
+	//周遭8格相對於自己的位移量
+	int offsetIndex = 0;
+	for (int i = -1; i <= 1; i++)
 	{
-		cells[i] = new CellCore[_cols];
+		for (int j = -1; j <= 1; j++)
+		{
+			if (i == 0 && j == 0)
+			{
+				continue;
+			}
+			neighborOffsets[offsetIndex++] = i * stride + j;
+		}
 	}
 }
 
@@ -73,6 +263,8 @@ void BoardCore::AllocateMem(int _rows, int _cols)
 void BoardCore::Load(int _rows, int _cols)
 {
 	AllocateMem(_rows, _cols);
+	bitBoardReady = false;
+	componentsReady = false;
 	rows = _rows;
 	cols = _cols;
 }
@@ -91,32 +283,211 @@ void BoardCore::Load(bool** isBombMap, int _rows, int _cols)
 	rows = _rows;
 	cols = _cols;
 	totalBombCount = 0;
+	unsigned char* bytes = reinterpret_cast<unsigned char*>(cells);
 	for (int i = 0; i < rows; i++)
 	{
+		unsigned char* row = bytes + CellIndex(i, 0);
 		for (int j = 0; j < cols; j++)
 		{
-			cells[i][j].SetBomb(isBombMap[i][j]);
+			row[j] = (row[j] & ~CellCore::BOMB_MASK) | (isBombMap[i][j] ? CellCore::BOMB_MASK : 0);
 		}
 	}
 	Refresh();
 }
 
 /**
- * Intent :	清除已有資訊，並釋放記憶體
- * Pre :
+ * Intent : 用bit-packed的炸彈平面載入盤面，有預先計算好的數字平面時直接使用，不重新計算
+ * Pre : bombPlane每列有 (cols + 63) / 64 個word，第j格為第 j / 64 個word的第 j % 64 個bit
+ *       countPlane為nullptr，或每列有 (cols + 1) / 2 個byte，每格4bit，偶數col在低位
+ * Post : 載入完成，所有格子為關閉狀態
+ * \param bombPlane 炸彈平面
+ * \param countPlane 數字平面 (可為nullptr)
+ * \param _rows row數量
+ * \param _cols col數量
+ */
+void BoardCore::LoadPlanes(const std::uint64_t* bombPlane, const unsigned char* countPlane, int _rows, int _cols)
+{
+	AllocateMem(_rows, _cols);
+	rows = _rows;
+	cols = _cols;
+	bitBoardReady = false;
+	componentsReady = false;
+	unsigned char* bytes = reinterpret_cast<unsigned char*>(cells);
+	size_t wordsPerRow = ((size_t)cols + 63) / 64;
+	size_t countBytesPerRow = ((size_t)cols + 1) / 2;
+	int tileCount = RowTileCount();
+	tileCounts.assign(tileCount, 0);
+	int* tileBombCount = tileCounts.data();
+
+	//每列互相獨立，直接由平面展開成關閉狀態的格子，炸彈數量以popcount計算
+	//列尾不足一個word的部分要遮掉，避免檔案中多餘的bit被算進去
+	std::uint64_t lastWordMask = (cols & 63) == 0 ? ~(std::uint64_t)0 : ((std::uint64_t)1 << (cols & 63)) - 1;
+	RunRowTiles(tileCount, [&](int tile, int beginRow, int endRow)
+	{
+		for (int i = beginRow; i < endRow; i++)
+		{
+			const std::uint64_t* bombRow = bombPlane + i * wordsPerRow;
+			const unsigned char* countRow = countPlane != nullptr ? countPlane + i * countBytesPerRow : nullptr;
+			ExpandPlaneRow(bytes + CellIndex(i, 0), bombRow, countRow, cols);
+
+			int rowBombCount = 0;
+			for (size_t w = 0; w + 1 < wordsPerRow; w++)
+			{
+				rowBombCount += BitBoardCore::PopCount(bombRow[w]);
+			}
+			rowBombCount += BitBoardCore::PopCount(bombRow[wordsPerRow - 1] & lastWordMask);
+			tileBombCount[tile] += rowBombCount;
+		}
+	});
+
+	//沒有預先計算好的數字時才重新計算
+	if (countPlane == nullptr)
+	{
+		RefreshNearBombCount();
+	}
+
+	//所有格子都是關閉狀態，count可以直接決定，不需要再掃過整個盤面
+	totalBombCount = 0;
+	for (int tile = 0; tile < tileCount; tile++)
+	{
+		totalBombCount += tileBombCount[tile];
+	}
+	totalFlagCount = 0;
+	totalBlankCount = rows * cols - totalBombCount;
+	openBlankCount = 0;
+	remainBlankCount = totalBlankCount;
+
+	//component模式在載入時就先標記好0區域
+	if (floodFillMode == FloodFillMode::COMPONENT)
+	{
+		BuildComponents();
+	}
+}
+
+/**
+ * Intent : 逐列直接填入格子的byte來載入盤面，填完後重新計算count
+ * Pre : fillRow只寫入炸彈bit，其餘bit為0 (關閉狀態)
+ * Post : 成功時載入完成，失敗時釋放記憶體
+ * \param _rows row數量
+ * \param _cols col數量
+ * \param fillRow 依序對每一列呼叫，參數為 (row位置, 該列第一個格子的byte位置)，回傳false時中止載入
+ * \return 是否成功
+ */
+bool BoardCore::LoadRows(int _rows, int _cols, const std::function<bool(int, unsigned char*)>& fillRow)
+{
+	Load(_rows, _cols);
+	unsigned char* bytes = reinterpret_cast<unsigned char*>(cells);
+
+	for (int i = 0; i < rows; i++)
+	{
+		if (!fillRow(i, bytes + CellIndex(i, 0)))
+		{
+			Clear();
+			return false;
+		}
+	}
+
+	Refresh();
+	return true;
+}
+
+/**
+ * Intent : 把盤面輸出成bit-packed的炸彈平面與數字平面 (格式與LoadPlanes相同)
+ * Pre : 已載入，buffer大小足夠
  * Post :
+ * \param bombPlane 輸出的炸彈平面
+ * \param countPlane 輸出的數字平面 (可為nullptr)
  */
-void BoardCore::Clear()
+void BoardCore::StorePlanes(std::uint64_t* bombPlane, unsigned char* countPlane)
 {
-	if (cells != nullptr)
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(cells);
+	size_t wordsPerRow = ((size_t)cols + 63) / 64;
+	size_t countBytesPerRow = ((size_t)cols + 1) / 2;
+
+	RunRowTiles(RowTileCount(), [&](int /*tile*/, int beginRow, int endRow)
 	{
-		for (int i = 0; i < rows; i++)
+		for (int i = beginRow; i < endRow; i++)
 		{
-			delete[] cells[i];
+			const unsigned char* row = bytes + CellIndex(i, 0);
+			std::uint64_t* bombRow = bombPlane + i * wordsPerRow;
+			for (size_t w = 0; w < wordsPerRow; w++)
+			{
+				std::uint64_t word = 0;
+				int count = (int)min((size_t)64, (size_t)cols - w * 64);
+				for (int k = 0; k < count; k++)
+				{
+					word |= (std::uint64_t)(row[w * 64 + k] & CellCore::BOMB_MASK) << k;
+				}
+				bombRow[w] = word;
+			}
+
+			if (countPlane == nullptr)
+			{
+				continue;
+			}
+
+			//列尾沒有用到的4bit填0
+			unsigned char* countRow = countPlane + i * countBytesPerRow;
+			memset(countRow, 0, countBytesPerRow);
+			for (int j = 0; j < cols; j++)
+			{
+				unsigned char nearBombCount = (row[j] & CellCore::COUNT_MASK) >> CellCore::COUNT_SHIFT;
+				countRow[j >> 1] |= nearBombCount << ((j & 1) * 4);
+			}
 		}
+	});
+}
 
-		delete[] cells;
-		cells = nullptr;
+/**
+ * Intent : 複製另一個盤面的整塊格子記憶體與count (格子狀態也一併複製)，不需要重新計算
+ * Pre : source已載入
+ * Post : 載入完成
+ * \param source 要複製的盤面
+ */
+void BoardCore::CopyFrom(const BoardCore& source)
+{
+	Load(source.rows, source.cols);
+	memcpy(reinterpret_cast<unsigned char*>(cells), reinterpret_cast<const unsigned char*>(source.cells), source.GetMemorySize());
+
+	totalBombCount = source.totalBombCount;
+	totalFlagCount = source.totalFlagCount;
+	totalBlankCount = source.totalBlankCount;
+	openBlankCount = source.openBlankCount;
+	remainBlankCount = source.remainBlankCount;
+
+	//component模式在載入時就先標記好0區域
+	if (floodFillMode == FloodFillMode::COMPONENT)
+	{
+		BuildComponents();
+	}
+}
+
+/**
+ * Intent : 回傳盤面格子記憶體的大小 (含外圍的哨兵格子)
+ * Pre :
+ * Post :
+ * \return 格子記憶體的byte數
+ */
+size_t BoardCore::GetMemorySize() const
+{
+	if (!loaded)
+	{
+		return 0;
+	}
+	return ((size_t)rows + 2) * stride * sizeof(CellCore);
+}
+
+/**
+ * Intent :	清除已有資訊，格子記憶體保留給下一次載入重複使用
+ * Pre :
+ * Post : 未載入狀態
+ */
+void BoardCore::Clear()
+{
+	if (loaded)
+	{
+		loaded = false;
+		stride = 0;
 		rows = 0;
 		cols = 0;
 		totalBombCount = 0;
@@ -124,7 +495,54 @@ void BoardCore::Clear()
 		totalBlankCount = 0;
 		openBlankCount = 0;
 		remainBlankCount = 0;
+		bitBoardReady = false;
+		componentsReady = false;
+	}
+}
+
+/**
+ * Intent : 釋放保留的格子記憶體與運算用的buffer
+ * Pre : 未載入 (Clear之後)
+ * Post : 保留的記憶體超過maxBytes時全部釋放
+ * \param maxBytes 可以保留的記憶體上限 (byte)
+ */
+void BoardCore::ShrinkMem(size_t maxBytes)
+{
+	if (loaded || GetRetainedMemorySize() <= maxBytes)
+	{
+		return;
 	}
+
+	delete[] cells;
+	cells = nullptr;
+	cellCapacity = 0;
+
+	//其餘buffer的大小都跟著盤面大小，一起釋放
+	vector<size_t>().swap(floodQueue);
+	vector<int>().swap(componentLabels);
+	vector<size_t>().swap(componentStarts);
+	vector<size_t>().swap(componentCells);
+	vector<char>().swap(componentDirty);
+	vector<unsigned char>().swap(bombSumRows);
+	vector<size_t>().swap(componentFillPositions);
+	vector<int>().swap(componentParents);
+	vector<int>().swap(tileCounts);
+	bitBoard.ShrinkMem();
+}
+
+/**
+ * Intent : 回傳格子記憶體與運算用的buffer保留的記憶體大小 (含未使用的容量)
+ * Pre :
+ * Post :
+ * \return 保留的byte數
+ */
+size_t BoardCore::GetRetainedMemorySize() const
+{
+	//flood fill與0區域的buffer每格都佔好幾個byte，比格子本身大很多，都要算進去
+	size_t positionCount = floodQueue.capacity() + componentStarts.capacity() + componentCells.capacity() + componentFillPositions.capacity();
+	size_t intCount = componentLabels.capacity() + componentParents.capacity() + tileCounts.capacity();
+	return cellCapacity * sizeof(CellCore) + positionCount * sizeof(size_t) + intCount * sizeof(int)
+		+ componentDirty.capacity() + bombSumRows.capacity() + bitBoard.GetRetainedMemorySize();
 }
 
 /**
@@ -135,26 +553,81 @@ void BoardCore::Clear()
  */
 bool BoardCore::IsLoaded()
 {
-	return cells != nullptr;
+	return loaded;
+}
+
+/**
+ * Intent : 建立格子byte對應到顯示字元的表
+ * Pre :
+ * Post :
+ * \param answer true時為解答字元 (炸彈為X 其餘為數字)，false時為目前顯示的字元
+ * \return 256個byte值對應的字元
+ */
+static std::array<char, 256> BuildCellCharTable(bool answer)
+{
+	std::array<char, 256> table = {};
+	for (int value = 0; value < 256; value++)
+	{
+		CellCore cell;
+		*reinterpret_cast<unsigned char*>(&cell) = (unsigned char)value;
+		table[value] = answer ? cell.GetAnswerChar() : cell.GetChar();
+	}
+	return table;
+}
+
+/**
+ * Intent : 把一列格子以查表轉成字元，直接寫進輸出緩衝區
+ * Pre :
+ * Post :
+ * \param output 輸出的緩衝區
+ * \param row 該列第一個格子的byte位置
+ * \param cols col數量
+ * \param charTable 格子byte對應到字元的表
+ * \param rowSplit row與row之間的分隔字串
+ * \param colSplit col與col之間的分隔字串
+ */
+static void PrintRow(OutputSinkCore& output, const unsigned char* row, int cols, const std::array<char, 256>& charTable, const std::string& rowSplit, const std::string& colSplit)
+{
+	size_t rowSize = (size_t)cols * (1 + colSplit.size()) + rowSplit.size();
+	char* out = output.Reserve(rowSize);
+
+	if (colSplit.size() == 1)
+	{
+		char split = colSplit[0];
+		for (int j = 0; j < cols; j++)
+		{
+			*out++ = charTable[row[j]];
+			*out++ = split;
+		}
+	}
+	else
+	{
+		for (int j = 0; j < cols; j++)
+		{
+			*out++ = charTable[row[j]];
+			memcpy(out, colSplit.data(), colSplit.size());
+			out += colSplit.size();
+		}
+	}
+	memcpy(out, rowSplit.data(), rowSplit.size());
+	output.Commit(rowSize);
 }
 
 /**
  * Intent : 印出盤面
  * Pre :
  * Post :
+ * \param output 輸出的緩衝區
  * \param rowSplit row與row之間的分隔字串，預設為換行
  * \param colSplit col與col之間的分隔字串，預設為一個空白
  */
-void BoardCore::Print(std::string rowSplit, std::string colSplit)
+void BoardCore::Print(OutputSinkCore& output, std::string rowSplit, std::string colSplit)
 {
+	static const std::array<char, 256> displayChars = BuildCellCharTable(false);
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(cells);
 	for (int i = 0; i < rows; i++)
 	{
-		for (int j = 0; j < cols; j++)
-		{
-			cells[i][j].Print();
-			cout << colSplit;
-		}
-		cout << rowSplit;
+		PrintRow(output, bytes + CellIndex(i, 0), cols, displayChars, rowSplit, colSplit);
 	}
 }
 
@@ -162,19 +635,17 @@ void BoardCore::Print(std::string rowSplit, std::string colSplit)
  * Intent : 印出盤面解答 (含炸彈位置與每格數字)
  * Pre :
  * Post :
+ * \param output 輸出的緩衝區
  * \param rowSplit row與row之間的分隔字串，預設為換行
  * \param colSplit col與col之間的分隔字串，預設為一個空白
  */
-void BoardCore::PrintAnswer(std::string rowSplit, std::string colSplit)
+void BoardCore::PrintAnswer(OutputSinkCore& output, std::string rowSplit, std::string colSplit)
 {
+	static const std::array<char, 256> answerChars = BuildCellCharTable(true);
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(cells);
 	for (int i = 0; i < rows; i++)
 	{
-		for (int j = 0; j < cols; j++)
-		{
-			cells[i][j].PrintAnswer();
-			cout << colSplit;
-		}
-		cout << rowSplit;
+		PrintRow(output, bytes + CellIndex(i, 0), cols, answerChars, rowSplit, colSplit);
 	}
 }
 
@@ -192,7 +663,7 @@ vector<string> BoardCore::Output()
 		string line;
 		for (int j = 0; j < cols; j++)
 		{
-			line.push_back(cells[i][j].GetChar());
+			line.push_back(cells[CellIndex(i, j)].GetChar());
 		}
 		result.push_back(line);
 	}
@@ -221,7 +692,29 @@ CellCore* BoardCore::GetCell(int row, int col)
 		return nullptr;
 	}
 
-	return &cells[row][col];
+	return &cells[CellIndex(row, col)];
+}
+
+/**
+ * Intent : 獲取row的數量
+ * Pre :
+ * Post :
+ * \return row的數量
+ */
+int BoardCore::GetRowCount()
+{
+	return rows;
+}
+
+/**
+ * Intent : 獲取col的數量
+ * Pre :
+ * Post :
+ * \return col的數量
+ */
+int BoardCore::GetColCount()
+{
+	return cols;
 }
 
 /**
@@ -231,9 +724,17 @@ CellCore* BoardCore::GetCell(int row, int col)
  */
 void BoardCore::Refresh()
 {
+	bitBoardReady = false;
+	componentsReady = false;
 	RefreshTotalCount();
 	RefreshNearBombCount();
 	RefreshOpenBlankCount();
+
+	//component模式在載入時就先標記好0區域
+	if (floodFillMode == FloodFillMode::COMPONENT)
+	{
+		BuildComponents();
+	}
 }
 
 /**
@@ -243,31 +744,45 @@ void BoardCore::Refresh()
  */
 void BoardCore::RefreshTotalCount()
 {
-	totalBombCount = 0;
-	totalBlankCount = 0;
-	totalFlagCount = 0;
-	for (int i = 0; i < rows; i++)
+	//直接以byte格式逐列掃描，迴圈中沒有分支，編譯器可以自動向量化
+	//每個tile各自加總，最後再合併
+	const unsigned char flaggedBits = (unsigned char)CellState::FLAGGED << CellCore::STATE_SHIFT;
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(cells);
+	int tileCount = RowTileCount();
+	tileCounts.assign((size_t)tileCount * 2, 0);
+	int* tileBombCount = tileCounts.data();
+	int* tileFlagCount = tileBombCount + tileCount;
+
+	RunRowTiles(tileCount, [&](int tile, int beginRow, int endRow)
 	{
-		for (int j = 0; j < cols; j++)
+		for (int i = beginRow; i < endRow; i++)
 		{
-			//計算炸彈數量
-			if (cells[i][j].IsBomb())
+			const unsigned char* row = bytes + CellIndex(i, 0);
+			int rowBombCount = 0;
+			int rowFlagCount = 0;
+			for (int j = 0; j < cols; j++)
 			{
-				totalBombCount++;
-			}
-			//計算空白數量
-			else
-			{
-				totalBlankCount++;
-			}
+				//計算炸彈數量
+				rowBombCount += row[j] & CellCore::BOMB_MASK;
 
-			//計算旗幟數量
-			if (cells[i][j].GetState() == CellState::FLAGGED)
-			{
-				totalFlagCount++;
+				//計算旗幟數量
+				rowFlagCount += (row[j] & CellCore::STATE_MASK) == flaggedBits;
 			}
+			tileBombCount[tile] += rowBombCount;
+			tileFlagCount[tile] += rowFlagCount;
 		}
+	});
+
+	totalBombCount = 0;
+	totalFlagCount = 0;
+	for (int tile = 0; tile < tileCount; tile++)
+	{
+		totalBombCount += tileBombCount[tile];
+		totalFlagCount += tileFlagCount[tile];
 	}
+
+	//計算空白數量
+	totalBlankCount = rows * cols - totalBombCount;
 }
 
 /**
@@ -277,32 +792,92 @@ void BoardCore::RefreshTotalCount()
  */
 void BoardCore::RefreshNearBombCount()
 {
-	for (int i = 0; i < rows; i++)
+	if (rows <= 0 || cols <= 0)
 	{
-		for (int j = 0; j < cols; j++)
-		{
-			cells[i][j].SetNearBombCount(GetNearBombCount(i, j));
-		}
+		return;
 	}
-}
 
-/**
- * Intent : 重新計算已開啟的格子數
- * Pre :
- * Post :
- */
-void BoardCore::RefreshOpenBlankCount()
-{
-	openBlankCount = 0;
-	for (int i = 0; i < rows; i++)
+	//九宮格的加總拆成先水平、再垂直的box filter，一次處理一整列
+	//每個tile有5列buffer : 上下halo列的水平加總 + 最近3列的水平加總，buffer會重複使用
+	int tileCount = RowTileCount();
+	size_t tileBufferSize = (size_t)5 * cols;
+	bombSumRows.resize(tileCount * tileBufferSize);
+	unsigned char* bytes = reinterpret_cast<unsigned char*>(cells);
+
+	//第一階段 : 先算好每個tile上下halo列的水平加總
+	//相鄰的tile會在第二階段改寫這些列的count bits，所以halo必須在任何寫入之前讀完
+	RunRowTiles(tileCount, [&](int tile, int beginRow, int endRow)
 	{
-		for (int j = 0; j < cols; j++)
-		{
-			if (cells[i][j].GetState() == CellState::OPENED)
+		unsigned char* haloUp = &bombSumRows[tile * tileBufferSize];
+		unsigned char* haloDown = haloUp + cols;
+
+		//上下的哨兵列沒有炸彈，CellIndex(-1, 0)與CellIndex(rows, 0)剛好是哨兵列
+		HorizontalBombSum(bytes + CellIndex(beginRow - 1, 0), haloUp, cols);
+		HorizontalBombSum(bytes + CellIndex(endRow, 0), haloDown, cols);
+	});
+
+	//第二階段 : 每個tile只寫入自己範圍內的列
+	RunRowTiles(tileCount, [&](int tile, int beginRow, int endRow)
+	{
+		unsigned char* haloUp = &bombSumRows[tile * tileBufferSize];
+		unsigned char* haloDown = haloUp + cols;
+		unsigned char* sumRows[3] = { haloDown + cols, haloDown + 2 * cols, haloDown + 3 * cols };
+
+		memcpy(sumRows[0], haloUp, cols);
+		HorizontalBombSum(bytes + CellIndex(beginRow, 0), sumRows[1], cols);
+
+		for (int i = beginRow; i < endRow; i++)
+		{
+			int k = i - beginRow;
+			unsigned char* up = sumRows[k % 3];
+			unsigned char* middle = sumRows[(k + 1) % 3];
+			unsigned char* down = sumRows[(k + 2) % 3];
+
+			//下一列 (tile的最後一列時使用halo)
+			if (i + 1 < endRow)
+			{
+				HorizontalBombSum(bytes + CellIndex(i + 1, 0), down, cols);
+			}
+			else
+			{
+				memcpy(down, haloDown, cols);
+			}
+			StoreNearBombCount(bytes + CellIndex(i, 0), up, middle, down, cols);
+		}
+	});
+}
+
+/**
+ * Intent : 重新計算已開啟的格子數
+ * Pre :
+ * Post :
+ */
+void BoardCore::RefreshOpenBlankCount()
+{
+	const unsigned char openedBits = (unsigned char)CellState::OPENED << CellCore::STATE_SHIFT;
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(cells);
+	int tileCount = RowTileCount();
+	tileCounts.assign(tileCount, 0);
+	int* tileOpenCount = tileCounts.data();
+
+	RunRowTiles(tileCount, [&](int tile, int beginRow, int endRow)
+	{
+		for (int i = beginRow; i < endRow; i++)
+		{
+			const unsigned char* row = bytes + CellIndex(i, 0);
+			int rowOpenCount = 0;
+			for (int j = 0; j < cols; j++)
 			{
-				openBlankCount++;
+				rowOpenCount += (row[j] & CellCore::STATE_MASK) == openedBits;
 			}
+			tileOpenCount[tile] += rowOpenCount;
 		}
+	});
+
+	openBlankCount = 0;
+	for (int tile = 0; tile < tileCount; tile++)
+	{
+		openBlankCount += tileOpenCount[tile];
 	}
 	remainBlankCount = totalBlankCount - openBlankCount;
 }
@@ -348,32 +923,15 @@ int BoardCore::GetNearBombCount(int row, int col)
 	}
 
 	int nearBombCount = 0;
+	size_t index = CellIndex(row, col);
 
-	//掃過周遭九宮格
-	for (int i = -1; i <= 1; i++)
+	//外圍有哨兵格子，直接用固定位移量掃過周遭8格，不需要檢查邊界
+	for (int k = 0; k < 8; k++)
 	{
-		int checkRow = row + i;
-		for (int j = -1; j <= 1; j++)
+		//如果是炸彈，計數器加1
+		if (cells[index + neighborOffsets[k]].IsBomb())
 		{
-			int checkCol = col + j;
-
-			//跳過自己
-			if (checkRow == row && checkCol == col)
-			{
-				continue;
-			}
-
-			//如果超出邊界，忽略掉
-			if (!ValidRowCol(checkRow, checkCol))
-			{
-				continue;
-			}
-
-			//如果是炸彈，計數器加1
-			if (cells[checkRow][checkCol].IsBomb())
-			{
-				nearBombCount++;
-			}
+			nearBombCount++;
 		}
 	}
 	return nearBombCount;
@@ -439,15 +997,933 @@ int BoardCore::GetRemainBlankCount()
 /**
  * Intent : 把所有格子都開啟，遊戲結束顯示解答時使用
  * Pre :
- * Post : 盤面上的所有格子都被開啟
+ * Post : 盤面上的所有格子都被開啟 (count維持遊戲結束當下的數值)
  */
 void BoardCore::UncoverAll()
 {
+	const unsigned char openedBits = (unsigned char)CellState::OPENED << CellCore::STATE_SHIFT;
+	unsigned char* bytes = reinterpret_cast<unsigned char*>(cells);
+	bitBoardReady = false;
+
+	RunRowTiles(RowTileCount(), [&](int /*tile*/, int beginRow, int endRow)
+	{
+		for (int i = beginRow; i < endRow; i++)
+		{
+			unsigned char* row = bytes + CellIndex(i, 0);
+			for (int j = 0; j < cols; j++)
+			{
+				row[j] = (row[j] & ~CellCore::STATE_MASK) | openedBits;
+			}
+		}
+	});
+}
+
+/**
+ * Intent : 從指定格子開始開啟整個區域 (flood fill)，遇到0的格子會繼續往周遭8格擴散
+ * Pre : 該格不是炸彈
+ * Post : 該區域內可開啟的格子都被開啟
+ * \param row row位置
+ * \param col col位置
+ */
+void BoardCore::FloodOpen(int row, int col)
+{
+	//防呆機制
+	if (!ValidRowCol(row, col))
+	{
+		return;
+	}
+
+	size_t startIndex = CellIndex(row, col);
+	CellCore* cell = &cells[startIndex];
+
+	//只開啟關閉或標註問號的空白格子
+	if (!cell->CanBeLeftClick() || cell->IsBomb())
+	{
+		return;
+	}
+
+	//bitboard模式以整列的bitwise運算開啟整個區域
+	if (floodFillMode == FloodFillMode::BITBOARD)
+	{
+		BitBoardFloodOpen(row, col);
+		return;
+	}
+
+	//scanline模式以整段水平的0格子為單位擴散
+	if (floodFillMode == FloodFillMode::SCANLINE)
+	{
+		ScanlineFloodOpen(startIndex);
+		return;
+	}
+
+	//component模式直接開啟載入時標記好的區域，區域失效時改用工作佇列
+	if (floodFillMode == FloodFillMode::COMPONENT && ComponentFloodOpen(startIndex))
+	{
+		return;
+	}
+
+	OpenCell(cell);
+
+	//不是0的格子不需要擴散
+	if (cell->GetNearBombCount() != 0)
+	{
+		return;
+	}
+
+	//用明確的工作佇列取代遞迴，stack用量固定，佇列的容量會被保留下來重複使用
+	floodQueue.clear();
+	floodQueue.push_back(startIndex);
+
+	while (!floodQueue.empty())
+	{
+		size_t index = floodQueue.back();
+		floodQueue.pop_back();
+
+		//掃過周遭8格，哨兵格子為開啟狀態，會跟已開啟的格子一樣被跳過
+		for (int k = 0; k < 8; k++)
+		{
+			size_t nearIndex = index + neighborOffsets[k];
+			CellCore* nearCell = &cells[nearIndex];
+
+			//已開啟、旗幟或炸彈都不能被開啟
+			if (!nearCell->CanBeLeftClick() || nearCell->IsBomb())
+			{
+				continue;
+			}
+
+			OpenCell(nearCell);
+
+			//如果該格是0，放入佇列繼續擴散
+			if (nearCell->GetNearBombCount() == 0)
+			{
+				floodQueue.push_back(nearIndex);
+			}
+		}
+	}
+}
+
+/**
+ * Intent : 對該格執行RightClick標註，並同步更新旗幟數量
+ * Pre :
+ * Post : 標註完成
+ * \param row row位置
+ * \param col col位置
+ */
+void BoardCore::RightClickCell(int row, int col)
+{
+	//防呆機制
+	if (!ValidRowCol(row, col))
+	{
+		return;
+	}
+
+	CellCore* cell = &cells[CellIndex(row, col)];
+	CellState oldState = cell->GetState();
+	cell->RightClick();
+	CellState newState = cell->GetState();
+
+	if (changeLog != nullptr)
+	{
+		changeLog->push_back({ row, col });
+	}
+
+	//bitboard已建立時同步該格的狀態
+	if (bitBoardReady)
+	{
+		bitBoard.SetState(row, col, newState);
+	}
+
+	//0的格子被插上旗幟後會擋住擴散，所屬區域不能再整塊開啟
+	if (componentsReady && newState == CellState::FLAGGED)
+	{
+		int label = componentLabels[CellIndex(row, col)];
+		if (label >= 0)
+		{
+			componentDirty[label] = 1;
+		}
+	}
+
+	//只有進出旗幟狀態會影響旗幟數量
+	if (oldState != CellState::FLAGGED && newState == CellState::FLAGGED)
+	{
+		totalFlagCount++;
+	}
+	else if (oldState == CellState::FLAGGED && newState != CellState::FLAGGED)
+	{
+		totalFlagCount--;
+	}
+}
+
+/**
+ * Intent : 設定記錄格子變更的位置，之後FloodOpen與RightClickCell改變的格子都會附加到該vector
+ * Pre :
+ * Post : 設定完成
+ * \param log 記錄的vector (nullptr代表不記錄)
+ */
+void BoardCore::SetChangeLog(std::vector<CellChange>* log)
+{
+	changeLog = log;
+}
+
+/**
+ * Intent : 將該格設為開啟狀態，並同步更新已開啟/剩餘的空白格子數量
+ * Pre : 該格可以被開啟且不是炸彈
+ * Post : 該格為開啟狀態
+ * \param cell 格子指標
+ */
+void BoardCore::OpenCell(CellCore* cell)
+{
+	cell->SetState(CellState::OPENED);
+	openBlankCount++;
+	remainBlankCount--;
+
+	if (changeLog != nullptr)
+	{
+		LogChange(cell - cells);
+	}
+
+	//不經過bitboard開啟的格子會讓bitboard失效
+	bitBoardReady = false;
+}
+
+/**
+ * Intent : 把cells中的位置轉換成row col，附加到變更紀錄
+ * Pre : 已設定變更紀錄
+ * Post :
+ * \param index 在cells中的位置
+ */
+void BoardCore::LogChange(size_t index)
+{
+	changeLog->push_back({ (long long)(index / stride) - 1, (long long)(index % stride) - 1 });
+}
+
+/**
+ * Intent : 以bitboard開啟整個區域，再把結果寫回格子並以popcount更新count
+ * Pre : 該格可以被開啟且不是炸彈
+ * Post : 該區域內可開啟的格子都被開啟
+ * \param row row位置
+ * \param col col位置
+ */
+void BoardCore::BitBoardFloodOpen(int row, int col)
+{
+	size_t baseIndex = CellIndex(0, 0);
+
+	//第一次使用或格子被其他方式改變過時，重新建立bitboard
+	if (!bitBoardReady)
+	{
+		bitBoard.Build(reinterpret_cast<unsigned char*>(cells) + baseIndex, stride, rows, cols);
+		bitBoardReady = true;
+	}
+
+	long long openedCount = bitBoard.FloodOpen(row, col, floodQueue);
+	for (size_t offset : floodQueue)
+	{
+		cells[baseIndex + offset].SetState(CellState::OPENED);
+	}
+	if (changeLog != nullptr)
+	{
+		for (size_t offset : floodQueue)
+		{
+			LogChange(baseIndex + offset);
+		}
+	}
+	openBlankCount += (int)openedCount;
+	remainBlankCount -= (int)openedCount;
+}
+
+/**
+ * Intent : 以水平區段 (scanline) 的方式開啟整個區域，一次處理一整段連續的0格子
+ * Pre : 該格可以被開啟且不是炸彈
+ * Post : 該區域內可開啟的格子都被開啟
+ * \param startIndex 起始格子在cells中的位置
+ */
+void BoardCore::ScanlineFloodOpen(size_t startIndex)
+{
+	CellCore* cell = &cells[startIndex];
+
+	//不是0的格子只開啟自己
+	if (cell->GetNearBombCount() != 0)
+	{
+		OpenCell(cell);
+		return;
+	}
+
+	//可以繼續擴散的格子 : 尚未開啟 (關閉或問號) 的0格子，哨兵格子為開啟狀態不會被選到
+	auto canExpand = [&](size_t index)
+	{
+		return cells[index].CanBeLeftClick() && !cells[index].IsBomb() && cells[index].GetNearBombCount() == 0;
+	};
+
+	//可以被開啟的格子 : 關閉或問號且不是炸彈
+	auto openIfPossible = [&](size_t index)
+	{
+		if (cells[index].CanBeLeftClick() && !cells[index].IsBomb())
+		{
+			OpenCell(&cells[index]);
+		}
+	};
+
+	//佇列中放的是每段0格子的其中一格
+	floodQueue.clear();
+	floodQueue.push_back(startIndex);
+
+	while (!floodQueue.empty())
+	{
+		size_t seed = floodQueue.back();
+		floodQueue.pop_back();
+
+		//已被其他區段開啟過
+		if (!canExpand(seed))
+		{
+			continue;
+		}
+
+		//往左右延伸出整段連續的0格子
+		size_t left = seed;
+		size_t right = seed;
+		while (canExpand(left - 1))
+		{
+			left--;
+		}
+		while (canExpand(right + 1))
+		{
+			right++;
+		}
+
+		//開啟整段0格子與左右兩端的格子
+		for (size_t index = left - 1; index <= right + 1; index++)
+		{
+			openIfPossible(index);
+		}
+
+		//上下兩列在[left - 1, right + 1]範圍內 : 數字格子直接開啟，每段連續的0格子放一個種子
+		for (int direction = -1; direction <= 1; direction += 2)
+		{
+			bool inRun = false;
+			for (size_t index = left - 1; index <= right + 1; index++)
+			{
+				size_t nearIndex = direction < 0 ? index - stride : index + stride;
+				if (canExpand(nearIndex))
+				{
+					if (!inRun)
+					{
+						floodQueue.push_back(nearIndex);
+						inRun = true;
+					}
+				}
+				else
+				{
+					openIfPossible(nearIndex);
+					inRun = false;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Intent : 以union-find標記所有0區域，並整理出每個區域要開啟的格子 (0格子與周遭的數字格子)
+ * Pre : near bomb count已計算完成
+ * Post : 標記完成，區域中已有0格子被插上旗幟時標記為dirty
+ */
+void BoardCore::BuildComponents()
+{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(cells);
+	size_t cellCount = (size_t)(rows + 2) * stride;
+
+	//第一階段 : 逐列掃描，用左、左上、上、右上已標記的0格子決定暫時編號 (union-find)
+	componentLabels.assign(cellCount, -1);
+	vector<int>& parent = componentParents;
+	parent.clear();
+	auto findRoot = [&](int label)
+	{
+		while (parent[label] != label)
+		{
+			parent[label] = parent[parent[label]];
+			label = parent[label];
+		}
+		return label;
+	};
+	auto unite = [&](int a, int b)
+	{
+		a = findRoot(a);
+		b = findRoot(b);
+
+		//較小的編號當作root
+		if (a < b)
+		{
+			parent[b] = a;
+		}
+		else if (b < a)
+		{
+			parent[a] = b;
+		}
+	};
+
+	for (int i = 0; i < rows; i++)
+	{
+		size_t rowIndex = CellIndex(i, 0);
+		for (int j = 0; j < cols; j++)
+		{
+			size_t index = rowIndex + j;
+
+			//只標記0的格子 (不是炸彈且周遭沒有炸彈)
+			if (bytes[index] & (CellCore::BOMB_MASK | CellCore::COUNT_MASK))
+			{
+				continue;
+			}
+
+			int up = componentLabels[index - stride];
+			int left = componentLabels[index - 1];
+			int upLeft = componentLabels[index - stride - 1];
+			int upRight = componentLabels[index - stride + 1];
+
+			//上方與其他三格都相鄰，已經在同一個區域，不需要合併
+			if (up >= 0)
+			{
+				componentLabels[index] = up;
+			}
+			else if (left >= 0)
+			{
+				componentLabels[index] = left;
+				if (upRight >= 0)
+				{
+					unite(left, upRight);
+				}
+			}
+			else if (upLeft >= 0)
+			{
+				componentLabels[index] = upLeft;
+				if (upRight >= 0)
+				{
+					unite(upLeft, upRight);
+				}
+			}
+			else if (upRight >= 0)
+			{
+				componentLabels[index] = upRight;
+			}
+			else
+			{
+				componentLabels[index] = (int)parent.size();
+				parent.push_back((int)parent.size());
+			}
+		}
+	}
+
+	//把暫時編號壓縮成連續的區域編號
+	int componentCount = 0;
+	for (size_t label = 0; label < parent.size(); label++)
+	{
+		parent[label] = (parent[label] == (int)label) ? componentCount++ : parent[parent[label]];
+	}
+
+	for (int i = 0; i < rows; i++)
+	{
+		size_t rowIndex = CellIndex(i, 0);
+		for (int j = 0; j < cols; j++)
+		{
+			size_t index = rowIndex + j;
+			if (componentLabels[index] >= 0)
+			{
+				componentLabels[index] = parent[componentLabels[index]];
+			}
+		}
+	}
+
+	//找出格子所屬的區域 : 0格子屬於自己的區域，數字格子屬於周遭0格子的區域
+	//周遭8格依環狀順序排列，環上相鄰的0格子必定在同一個區域，只有換區域時才記錄
+	const int ringOffsets[8] = { -stride - 1, -stride, -stride + 1, 1, stride + 1, stride, stride - 1, -1 };
+	auto collectComponents = [&](size_t index, int* found)
+	{
+		unsigned char cell = bytes[index];
+		if (cell & CellCore::BOMB_MASK)
+		{
+			return 0;
+		}
+
+		if ((cell & CellCore::COUNT_MASK) == 0)
+		{
+			found[0] = componentLabels[index];
+			return 1;
+		}
+
+		int foundCount = 0;
+		int lastLabel = componentLabels[index + ringOffsets[7]];
+		for (int k = 0; k < 8; k++)
+		{
+			int label = componentLabels[index + ringOffsets[k]];
+			if (label >= 0 && label != lastLabel)
+			{
+				found[foundCount++] = label;
+			}
+			lastLabel = label;
+		}
+
+		//周遭8格全部是同一個區域
+		if (foundCount == 0 && lastLabel >= 0)
+		{
+			found[foundCount++] = lastLabel;
+		}
+
+		//不相鄰的0格子也可能經由其他格子連成同一個區域，去除重複
+		if (foundCount > 1)
+		{
+			int uniqueCount = 1;
+			for (int f = 1; f < foundCount; f++)
+			{
+				bool repeated = false;
+				for (int u = 0; u < uniqueCount; u++)
+				{
+					repeated = repeated || found[u] == found[f];
+				}
+				if (!repeated)
+				{
+					found[uniqueCount++] = found[f];
+				}
+			}
+			foundCount = uniqueCount;
+		}
+		return foundCount;
+	};
+
+	//第二階段 : 計算每個區域的格子數量
+	int found[8];
+	componentStarts.assign(componentCount + 1, 0);
+	for (int i = 0; i < rows; i++)
+	{
+		size_t rowIndex = CellIndex(i, 0);
+		for (int j = 0; j < cols; j++)
+		{
+			int foundCount = collectComponents(rowIndex + j, found);
+			for (int f = 0; f < foundCount; f++)
+			{
+				componentStarts[found[f] + 1]++;
+			}
+		}
+	}
+	for (int k = 0; k < componentCount; k++)
+	{
+		componentStarts[k + 1] += componentStarts[k];
+	}
+
+	//第三階段 : 依區域編號填入格子位置 (counting sort)
+	componentCells.resize(componentStarts[componentCount]);
+	componentFillPositions.assign(componentStarts.begin(), componentStarts.end() - 1);
+	componentDirty.assign(componentCount, 0);
+	size_t* fillPositions = componentFillPositions.data();
+	for (int i = 0; i < rows; i++)
+	{
+		size_t rowIndex = CellIndex(i, 0);
+		for (int j = 0; j < cols; j++)
+		{
+			size_t index = rowIndex + j;
+			int foundCount = collectComponents(index, found);
+			for (int f = 0; f < foundCount; f++)
+			{
+				componentCells[fillPositions[found[f]]++] = index;
+			}
+
+			//區域還沒建立或失效時插上的旗幟不會被RightClickCell記錄，在這裡補上
+			if (componentLabels[index] >= 0 && cells[index].GetState() == CellState::FLAGGED)
+			{
+				componentDirty[componentLabels[index]] = 1;
+			}
+		}
+	}
+
+	componentsReady = true;
+}
+
+/**
+ * Intent : 直接開啟載入時標記好的0區域
+ * Pre : 該格可以被開啟且不是炸彈
+ * Post : 成功時該區域內可開啟的格子都被開啟
+ * \param startIndex 起始格子在cells中的位置
+ * \return 是否成功 (區域中有0格子被插過旗幟時，需改用工作佇列)
+ */
+bool BoardCore::ComponentFloodOpen(size_t startIndex)
+{
+	if (!componentsReady)
+	{
+		BuildComponents();
+	}
+
+	int label = componentLabels[startIndex];
+
+	//不是0的格子只開啟自己
+	if (label < 0)
+	{
+		OpenCell(&cells[startIndex]);
+		return true;
+	}
+
+	if (componentDirty[label])
+	{
+		return false;
+	}
+
+	for (size_t k = componentStarts[label]; k < componentStarts[label + 1]; k++)
+	{
+		CellCore* cell = &cells[componentCells[k]];
+
+		//已開啟或旗幟都不能被開啟 (區域內不會有炸彈)
+		if (cell->CanBeLeftClick())
+		{
+			OpenCell(cell);
+		}
+	}
+	return true;
+}
+
+/**
+ * Intent : 將row col轉換成連續記憶體中的位置 (含外圍哨兵格子)
+ * Pre : row col在範圍內
+ * Post :
+ * \param row row位置
+ * \param col col位置
+ * \return 在cells中的位置
+ */
+size_t BoardCore::CellIndex(int row, int col)
+{
+	return (size_t)(row + 1) * stride + (col + 1);
+}
+
+/**
+ * Intent : 用RandomRate模式產生炸彈，直接寫入盤面
+ * Pre : 已載入空的盤面
+ * Post : 炸彈產生完成，count重新計算完成
+ * \param bombRate 炸彈生成機率
+ * \param seed 隨機種子
+ */
+void BoardCore::GenerateRandomRate(float bombRate, std::uint64_t seed)
+{
+	//以固定列數切成block，每個block使用 (seed, block編號) 的counter-based隨機數串流
+	//block的切法與執行緒數量無關，所以相同的seed不論用幾個執行緒、在哪台機器上都會產生相同的盤面
+	int blockCount = (rows + GENERATE_BLOCK_ROWS - 1) / GENERATE_BLOCK_ROWS;
+	unsigned char* bytes = reinterpret_cast<unsigned char*>(cells);
+
+	//機率超過一半時改成對空白格子抽樣，跳躍的次數永遠不超過格子數的一半
+	bool sampleBlank = bombRate > 0.5f;
+	double sampleRate = sampleBlank ? 1.0 - bombRate : bombRate;
+	unsigned char fillBits = sampleBlank ? CellCore::BOMB_MASK : 0;
+
+	//幾何分佈跳躍使用的 (1-p)^(2^m) 表，所有block共用
+	double keepPowers[64];
+	int keepPowerCount = sampleRate > 0.0 ? RandomCore::BuildKeepPowers(1.0 - sampleRate, keepPowers) : 0;
+
+	ThreadPoolCore::Instance().Run(blockCount, [&](int block)
+	{
+		RandomCore random(seed, (std::uint64_t)block);
+
+		int beginRow = block * GENERATE_BLOCK_ROWS;
+		int endRow = min(beginRow + GENERATE_BLOCK_ROWS, rows);
+
+		//先把整個block填成多數的那一種
+		for (int i = beginRow; i < endRow; i++)
+		{
+			unsigned char* row = bytes + CellIndex(i, 0);
+			for (int j = 0; j < cols; j++)
+			{
+				row[j] = (row[j] & ~CellCore::BOMB_MASK) | fillBits;
+			}
+		}
+
+		if (sampleRate <= 0.0)
+		{
+			return;
+		}
+
+		//被選中的比例高時，跳躍的距離很短，計算跳躍的成本反而比逐格比較整數門檻高
+		if (sampleRate > GEOMETRIC_SKIP_MAX_RATE)
+		{
+			std::uint64_t threshold = (std::uint64_t)(sampleRate * 18446744073709551616.0);
+			for (int i = beginRow; i < endRow; i++)
+			{
+				unsigned char* row = bytes + CellIndex(i, 0);
+				for (int j = 0; j < cols; j++)
+				{
+					row[j] ^= (random.Next() < threshold) ? CellCore::BOMB_MASK : 0;
+				}
+			}
+			return;
+		}
+
+		//每格獨立以sampleRate被選中時，兩個被選中格子之間的間隔服從幾何分佈
+		//直接跳到下一個被選中的格子，隨機數只需要產生被選中的格子數次
+		long long blockCellCount = (long long)(endRow - beginRow) * cols;
+		long long position = -1;
+		while (true)
+		{
+			std::uint64_t gap = random.NextGeometricSkip(keepPowers, keepPowerCount);
+			if (gap >= (std::uint64_t)(blockCellCount - position - 1))
+			{
+				break;
+			}
+			position += (long long)gap + 1;
+
+			//被選中的格子與預先填入的相反 (炸彈<->空白)
+			unsigned char* cell = bytes + CellIndex(beginRow + (int)(position / cols), (int)(position % cols));
+			*cell ^= CellCore::BOMB_MASK;
+		}
+	}, RowTileCount());
+
+	Refresh();
+}
+
+/**
+ * Intent : 用RandomCount模式產生剛好bombCount顆炸彈 (Floyd抽樣)，直接寫入盤面
+ * Pre : 已載入空的盤面，0 <= bombCount <= rows * cols
+ * Post : 炸彈產生完成，count重新計算完成
+ * \param bombCount 炸彈數量
+ * \param seed 隨機種子
+ */
+void BoardCore::GenerateRandomCount(int bombCount, std::uint64_t seed)
+{
+	long long cellCount = (long long)rows * cols;
+
+	//防呆機制
+	if (bombCount < 0 || bombCount > cellCount)
+	{
+		return;
+	}
+
+	//先清掉所有炸彈
+	unsigned char* bytes = reinterpret_cast<unsigned char*>(cells);
 	for (int i = 0; i < rows; i++)
 	{
+		unsigned char* row = bytes + CellIndex(i, 0);
 		for (int j = 0; j < cols; j++)
 		{
-			cells[i][j].SetState(CellState::OPENED);
+			row[j] &= ~CellCore::BOMB_MASK;
+		}
+	}
+
+	//RandomCount只有一條隨機數串流，依序抽樣
+	RandomCore random(seed, RANDOM_COUNT_STREAM);
+
+	//Floyd抽樣 : 依序對 j = N - bombCount ... N - 1 從 [0, j] 中挑一格，
+	//若挑到的格子已經是炸彈，就改放在第j格 (第j格一定還不是炸彈)
+	//每一輪剛好放一顆炸彈，不論密度多高都是 O(bombCount)，盤面本身就是已選集合
+	for (long long j = cellCount - bombCount; j < cellCount; j++)
+	{
+		long long target = (long long)random.NextBelow((std::uint64_t)j + 1);
+		unsigned char* cell = bytes + CellIndex((int)(target / cols), (int)(target % cols));
+
+		if (*cell & CellCore::BOMB_MASK)
+		{
+			cell = bytes + CellIndex((int)(j / cols), (int)(j % cols));
+		}
+		*cell |= CellCore::BOMB_MASK;
+	}
+
+	Refresh();
+}
+
+/**
+ * Intent : 把點擊位置周遭九宮格內的炸彈搬到九宮格外的隨機空白格子，讓第一次點擊必定安全並開出0
+ *          若九宮格外的空白格子不夠，則只搬走點擊位置本身的炸彈
+ * Pre : 尚未開啟任何格子
+ * Post : 炸彈搬移完成，只更新被搬移炸彈周遭的near bomb count
+ * \param row 點擊的row位置
+ * \param col 點擊的col位置
+ * \param seed 隨機種子
+ */
+void BoardCore::RelocateBombsAround(int row, int col, std::uint64_t seed)
+{
+	//防呆機制
+	if (!ValidRowCol(row, col))
+	{
+		return;
+	}
+
+	//計算九宮格內 (在範圍內的格子) 的炸彈與空白數量
+	int zoneBombCount = 0;
+	int zoneBlankCount = 0;
+	for (int i = row - 1; i <= row + 1; i++)
+	{
+		for (int j = col - 1; j <= col + 1; j++)
+		{
+			if (!ValidRowCol(i, j))
+			{
+				continue;
+			}
+			if (cells[CellIndex(i, j)].IsBomb())
+			{
+				zoneBombCount++;
+			}
+			else
+			{
+				zoneBlankCount++;
+			}
+		}
+	}
+
+	//決定安全區 : 空白格子夠的話清空整個九宮格，否則只清空點擊的那一格
+	int safeRadius = 1;
+	if (totalBlankCount - zoneBlankCount < zoneBombCount)
+	{
+		safeRadius = 0;
+		if (!cells[CellIndex(row, col)].IsBomb() || totalBlankCount == 0)
+		{
+			return;
+		}
+	}
+
+	RandomCore random(seed, FIRST_CLICK_STREAM);
+	long long cellCount = (long long)rows * cols;
+	long long scanPosition = 0;
+
+	for (int i = row - safeRadius; i <= row + safeRadius; i++)
+	{
+		for (int j = col - safeRadius; j <= col + safeRadius; j++)
+		{
+			if (!ValidRowCol(i, j) || !cells[CellIndex(i, j)].IsBomb())
+			{
+				continue;
+			}
+
+			//隨機挑選安全區外的空白格子，太多次失敗 (盤面很密) 時改成依序尋找
+			long long target = -1;
+			for (int attempt = 0; attempt < RELOCATE_MAX_ATTEMPTS && target < 0; attempt++)
+			{
+				long long candidate = (long long)random.NextBelow((std::uint64_t)cellCount);
+				int candidateRow = (int)(candidate / cols);
+				int candidateCol = (int)(candidate % cols);
+				if (abs(candidateRow - row) > safeRadius || abs(candidateCol - col) > safeRadius)
+				{
+					if (!cells[CellIndex(candidateRow, candidateCol)].IsBomb())
+					{
+						target = candidate;
+					}
+				}
+			}
+			for (; target < 0 && scanPosition < cellCount; scanPosition++)
+			{
+				int candidateRow = (int)(scanPosition / cols);
+				int candidateCol = (int)(scanPosition % cols);
+				if (abs(candidateRow - row) > safeRadius || abs(candidateCol - col) > safeRadius)
+				{
+					if (!cells[CellIndex(candidateRow, candidateCol)].IsBomb())
+					{
+						target = scanPosition;
+					}
+				}
+			}
+
+			//前面已確認空白格子足夠，理論上一定找得到
+			if (target < 0)
+			{
+				return;
+			}
+
+			MoveBomb(i, j, (int)(target / cols), (int)(target % cols));
+		}
+	}
+}
+
+/**
+ * Intent : 把炸彈從一格搬到另一格，並更新兩格周遭的near bomb count
+ * Pre : from是炸彈，to不是炸彈
+ * Post : 搬移完成
+ * \param fromRow 原本的row位置
+ * \param fromCol 原本的col位置
+ * \param toRow 新的row位置
+ * \param toCol 新的col位置
+ */
+void BoardCore::MoveBomb(int fromRow, int fromCol, int toRow, int toCol)
+{
+	bitBoardReady = false;
+	componentsReady = false;
+	cells[CellIndex(fromRow, fromCol)].SetBomb(false);
+	AddNearBombCount(fromRow, fromCol, -1);
+
+	cells[CellIndex(toRow, toCol)].SetBomb(true);
+	AddNearBombCount(toRow, toCol, 1);
+}
+
+/**
+ * Intent : 將該格周遭8格的near bomb count加上delta
+ * Pre :
+ * Post :
+ * \param row row位置
+ * \param col col位置
+ * \param delta 變化量
+ */
+void BoardCore::AddNearBombCount(int row, int col, int delta)
+{
+	for (int i = row - 1; i <= row + 1; i++)
+	{
+		for (int j = col - 1; j <= col + 1; j++)
+		{
+			//跳過自己與哨兵格子
+			if ((i == row && j == col) || !ValidRowCol(i, j))
+			{
+				continue;
+			}
+
+			CellCore* cell = &cells[CellIndex(i, j)];
+			cell->SetNearBombCount(cell->GetNearBombCount() + delta);
 		}
 	}
 }
+
+/**
+ * Intent : 設定整盤運算 (Refresh、UncoverAll、隨機產生) 最多使用的執行緒數量
+ * Pre :
+ * Post : 設定完成
+ * \param _threadCount 執行緒數量，小於1時視為1
+ */
+void BoardCore::SetThreadCount(int _threadCount)
+{
+	threadCount = max(_threadCount, 1);
+}
+
+/**
+ * Intent : 回傳整盤運算最多使用的執行緒數量
+ * Pre :
+ * Post :
+ * \return 執行緒數量
+ */
+int BoardCore::GetThreadCount()
+{
+	return threadCount;
+}
+
+/**
+ * Intent : 設定flood fill的實作方式
+ * Pre :
+ * Post : 設定完成
+ * \param mode flood fill的實作方式
+ */
+void BoardCore::SetFloodFillMode(FloodFillMode mode)
+{
+	floodFillMode = mode;
+}
+
+/**
+ * Intent : 回傳flood fill的實作方式
+ * Pre :
+ * Post :
+ * \return flood fill的實作方式
+ */
+FloodFillMode BoardCore::GetFloodFillMode()
+{
+	return floodFillMode;
+}
+
+/**
+ * Intent : 決定整盤運算要切成幾個row tile
+ * Pre :
+ * Post :
+ * \return tile數量 (盤面太小時為1，不值得切分)
+ */
+int BoardCore::RowTileCount()
+{
+	if (threadCount <= 1 || (long long)rows * cols < PARALLEL_MIN_CELLS)
+	{
+		return 1;
+	}
+	return max(min(threadCount, rows), 1);
+}
+
@@ -14,8 +14,15 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <functional>
 
 #include "CellCore.h"
+#include "BitBoardCore.h"
+#include "RandomCore.h"
+#include "ThreadPoolCore.h"
 
  //列舉出載入模式
 enum class BoardCoreGenerateType
@@ -23,6 +30,16 @@ enum class BoardCoreGenerateType
 	FILE,
 	RANDOM_RATE,
 	RANDOM_COUNT,
+	INFINITE_RATE,
+};
+
+//列舉出flood fill的實作方式
+enum class FloodFillMode
+{
+	QUEUE,
+	BITBOARD,
+	SCANLINE,
+	COMPONENT,
 };
 
 class BoardCore
@@ -58,12 +75,76 @@ public:
 	void Load(bool**, int, int);
 
 	/**
-	 * Intent :	清除已有資訊，並釋放記憶體
+	 * Intent : 用bit-packed的炸彈平面載入盤面，有預先計算好的數字平面時直接使用，不重新計算
+	 * Pre : bombPlane每列有 (cols + 63) / 64 個word，第j格為第 j / 64 個word的第 j % 64 個bit
+	 *       countPlane為nullptr，或每列有 (cols + 1) / 2 個byte，每格4bit，偶數col在低位
+	 * Post : 載入完成，所有格子為關閉狀態
+	 * \param bombPlane 炸彈平面
+	 * \param countPlane 數字平面 (可為nullptr)
+	 * \param _rows row數量
+	 * \param _cols col數量
+	 */
+	void LoadPlanes(const std::uint64_t*, const unsigned char*, int, int);
+
+	/**
+	 * Intent : 逐列直接填入格子的byte來載入盤面，填完後重新計算count
+	 * Pre : fillRow只寫入炸彈bit，其餘bit為0 (關閉狀態)
+	 * Post : 成功時載入完成，失敗時釋放記憶體
+	 * \param _rows row數量
+	 * \param _cols col數量
+	 * \param fillRow 依序對每一列呼叫，參數為 (row位置, 該列第一個格子的byte位置)，回傳false時中止載入
+	 * \return 是否成功
+	 */
+	bool LoadRows(int, int, const std::function<bool(int, unsigned char*)>&);
+
+	/**
+	 * Intent : 把盤面輸出成bit-packed的炸彈平面與數字平面 (格式與LoadPlanes相同)
+	 * Pre : 已載入，buffer大小足夠
+	 * Post :
+	 * \param bombPlane 輸出的炸彈平面
+	 * \param countPlane 輸出的數字平面 (可為nullptr)
+	 */
+	void StorePlanes(std::uint64_t*, unsigned char*);
+
+	/**
+	 * Intent : 複製另一個盤面的整塊格子記憶體與count (格子狀態也一併複製)，不需要重新計算
+	 * Pre : source已載入
+	 * Post : 載入完成
+	 * \param source 要複製的盤面
+	 */
+	void CopyFrom(const BoardCore&);
+
+	/**
+	 * Intent : 回傳盤面格子記憶體的大小 (含外圍的哨兵格子)
 	 * Pre :
 	 * Post :
+	 * \return 格子記憶體的byte數
+	 */
+	size_t GetMemorySize() const;
+
+	/**
+	 * Intent :	清除已有資訊，格子記憶體保留給下一次載入重複使用
+	 * Pre :
+	 * Post : 未載入狀態
 	 */
 	void Clear();
 
+	/**
+	 * Intent : 釋放保留的格子記憶體與運算用的buffer
+	 * Pre : 未載入 (Clear之後)
+	 * Post : 保留的記憶體超過maxBytes時全部釋放
+	 * \param maxBytes 可以保留的記憶體上限 (byte)
+	 */
+	void ShrinkMem(size_t);
+
+	/**
+	 * Intent : 回傳格子記憶體與運算用的buffer保留的記憶體大小 (含未使用的容量)
+	 * Pre :
+	 * Post :
+	 * \return 保留的byte數
+	 */
+	size_t GetRetainedMemorySize() const;
+
 	/**
 	 * Intent : 是否已載入過盤面
 	 * Pre :
@@ -76,19 +157,21 @@ public:
 	 * Intent : 印出盤面
 	 * Pre :
 	 * Post :
+	 * \param output 輸出的緩衝區
 	 * \param rowSplit row與row之間的分隔字串，預設為換行
 	 * \param colSplit col與col之間的分隔字串，預設為一個空白
 	 */
-	void Print(std::string rowSplit = "\n", std::string colSplit = " ");
+	void Print(OutputSinkCore&, std::string rowSplit = "\n", std::string colSplit = " ");
 
 	/**
 	 * Intent : 印出盤面解答 (含炸彈位置與每格數字)
 	 * Pre :
 	 * Post :
+	 * \param output 輸出的緩衝區
 	 * \param rowSplit row與row之間的分隔字串，預設為換行
 	 * \param colSplit col與col之間的分隔字串，預設為一個空白
 	 */
-	void PrintAnswer(std::string rowSplit = "\n", std::string colSplit = " ");
+	void PrintAnswer(OutputSinkCore&, std::string rowSplit = "\n", std::string colSplit = " ");
 
 	/**
 	 * Intent :	輸出盤面，用char組成2維陣列去表示
@@ -108,6 +191,22 @@ public:
 	 */
 	CellCore* GetCell(int, int);
 
+	/**
+	 * Intent : 獲取row的數量
+	 * Pre :
+	 * Post :
+	 * \return row的數量
+	 */
+	int GetRowCount();
+
+	/**
+	 * Intent : 獲取col的數量
+	 * Pre :
+	 * Post :
+	 * \return col的數量
+	 */
+	int GetColCount();
+
 	/**
 	 * Intent : 更新盤面 (重新計算count)
 	 * Pre :
@@ -172,10 +271,193 @@ public:
 	 */
 	void UncoverAll();
 
+	/**
+	 * Intent : 從指定格子開始開啟整個區域 (flood fill)，遇到0的格子會繼續往周遭8格擴散
+	 * Pre : 該格不是炸彈
+	 * Post : 該區域內可開啟的格子都被開啟
+	 * \param row row位置
+	 * \param col col位置
+	 */
+	void FloodOpen(int, int);
+
+	/**
+	 * Intent : 對該格執行RightClick標註，並同步更新旗幟數量
+	 * Pre :
+	 * Post : 標註完成
+	 * \param row row位置
+	 * \param col col位置
+	 */
+	void RightClickCell(int, int);
+
+	/**
+	 * Intent : 設定記錄格子變更的位置，之後FloodOpen與RightClickCell改變的格子都會附加到該vector
+	 * Pre :
+	 * Post : 設定完成
+	 * \param log 記錄的vector (nullptr代表不記錄)
+	 */
+	void SetChangeLog(std::vector<CellChange>*);
+
+	/**
+	 * Intent : 用RandomRate模式產生炸彈，直接寫入盤面
+	 * Pre : 已載入空的盤面
+	 * Post : 炸彈產生完成，count重新計算完成
+	 * \param bombRate 炸彈生成機率
+	 * \param seed 隨機種子
+	 */
+	void GenerateRandomRate(float, std::uint64_t);
+
+	/**
+	 * Intent : 用RandomCount模式產生剛好bombCount顆炸彈 (Floyd抽樣)，直接寫入盤面
+	 * Pre : 已載入空的盤面，0 <= bombCount <= rows * cols
+	 * Post : 炸彈產生完成，count重新計算完成
+	 * \param bombCount 炸彈數量
+	 * \param seed 隨機種子
+	 */
+	void GenerateRandomCount(int, std::uint64_t);
+
+	/**
+	 * Intent : 把點擊位置周遭九宮格內的炸彈搬到九宮格外的隨機空白格子，讓第一次點擊必定安全並開出0
+	 *          若九宮格外的空白格子不夠，則只搬走點擊位置本身的炸彈
+	 * Pre : 尚未開啟任何格子
+	 * Post : 炸彈搬移完成，只更新被搬移炸彈周遭的near bomb count
+	 * \param row 點擊的row位置
+	 * \param col 點擊的col位置
+	 * \param seed 隨機種子
+	 */
+	void RelocateBombsAround(int, int, std::uint64_t);
+
+	/**
+	 * Intent : 設定整盤運算 (Refresh、UncoverAll、隨機產生) 最多使用的執行緒數量
+	 * Pre :
+	 * Post : 設定完成
+	 * \param _threadCount 執行緒數量，小於1時視為1
+	 */
+	void SetThreadCount(int);
+
+	/**
+	 * Intent : 回傳整盤運算最多使用的執行緒數量
+	 * Pre :
+	 * Post :
+	 * \return 執行緒數量
+	 */
+	int GetThreadCount();
+
+	/**
+	 * Intent : 設定flood fill的實作方式
+	 * Pre :
+	 * Post : 設定完成
+	 * \param mode flood fill的實作方式
+	 */
+	void SetFloodFillMode(FloodFillMode);
+
+	/**
+	 * Intent : 回傳flood fill的實作方式
+	 * Pre :
+	 * Post :
+	 * \return flood fill的實作方式
+	 */
+	FloodFillMode GetFloodFillMode();
+
 private:
 
 	/**
-	 * Intent : 重新配置2維陣列記憶體
+	 * Intent : 決定整盤運算要切成幾個row tile
+	 * Pre :
+	 * Post :
+	 * \return tile數量 (盤面太小時為1，不值得切分)
+	 */
+	int RowTileCount();
+
+	/**
+	 * Intent : 把盤面切成tileCount個連續的row tile，交給worker pool平行處理
+	 * Pre :
+	 * Post : 所有tile都處理完成
+	 * \param tileCount tile數量
+	 * \param work 每個tile要做的事，參數為 (tile編號, 起始row, 結束row(不含))
+	 */
+	template <typename Work>
+	void RunRowTiles(int tileCount, const Work& work)
+	{
+		ThreadPoolCore::Instance().Run(tileCount, [&](int tile)
+		{
+			int beginRow = (int)((long long)rows * tile / tileCount);
+			int endRow = (int)((long long)rows * (tile + 1) / tileCount);
+			work(tile, beginRow, endRow);
+		}, tileCount);
+	}
+
+	/**
+	 * Intent : 把炸彈從一格搬到另一格，並更新兩格周遭的near bomb count
+	 * Pre : from是炸彈，to不是炸彈
+	 * Post : 搬移完成
+	 * \param fromRow 原本的row位置
+	 * \param fromCol 原本的col位置
+	 * \param toRow 新的row位置
+	 * \param toCol 新的col位置
+	 */
+	void MoveBomb(int, int, int, int);
+
+	/**
+	 * Intent : 將該格周遭8格的near bomb count加上delta
+	 * Pre :
+	 * Post :
+	 * \param row row位置
+	 * \param col col位置
+	 * \param delta 變化量
+	 */
+	void AddNearBombCount(int, int, int);
+
+	/**
+	 * Intent : 將該格設為開啟狀態，並同步更新已開啟/剩餘的空白格子數量
+	 * Pre : 該格可以被開啟且不是炸彈
+	 * Post : 該格為開啟狀態
+	 * \param cell 格子指標
+	 */
+	void OpenCell(CellCore*);
+
+	/**
+	 * Intent : 把cells中的位置轉換成row col，附加到變更紀錄
+	 * Pre : 已設定變更紀錄
+	 * Post :
+	 * \param index 在cells中的位置
+	 */
+	void LogChange(size_t);
+
+	/**
+	 * Intent : 以bitboard開啟整個區域，再把結果寫回格子並以popcount更新count
+	 * Pre : 該格可以被開啟且不是炸彈
+	 * Post : 該區域內可開啟的格子都被開啟
+	 * \param row row位置
+	 * \param col col位置
+	 */
+	void BitBoardFloodOpen(int, int);
+
+	/**
+	 * Intent : 以水平區段 (scanline) 的方式開啟整個區域，一次處理一整段連續的0格子
+	 * Pre : 該格可以被開啟且不是炸彈
+	 * Post : 該區域內可開啟的格子都被開啟
+	 * \param startIndex 起始格子在cells中的位置
+	 */
+	void ScanlineFloodOpen(size_t);
+
+	/**
+	 * Intent : 以union-find標記所有0區域，並整理出每個區域要開啟的格子 (0格子與周遭的數字格子)
+	 * Pre : near bomb count已計算完成
+	 * Post : 標記完成，區域中已有0格子被插上旗幟時標記為dirty
+	 */
+	void BuildComponents();
+
+	/**
+	 * Intent : 直接開啟載入時標記好的0區域
+	 * Pre : 該格可以被開啟且不是炸彈
+	 * Post : 成功時該區域內可開啟的格子都被開啟
+	 * \param startIndex 起始格子在cells中的位置
+	 * \return 是否成功 (區域中有0格子被插過旗幟時，需改用工作佇列)
+	 */
+	bool ComponentFloodOpen(size_t);
+
+	/**
+	 * Intent : 重新配置盤面記憶體 (一次配置，外圍含一圈哨兵格子)
 	 * Pre :
 	 * Post : 配置完成
 	 * \param _rows row數量
@@ -214,19 +496,92 @@ private:
 	 */
 	bool ValidRowCol(int, int);
 
-	//儲存2維格子陣列
-	CellCore** cells = nullptr;
+	/**
+	 * Intent : 將row col轉換成連續記憶體中的位置 (含外圍哨兵格子)
+	 * Pre : row col在範圍內
+	 * Post :
+	 * \param row row位置
+	 * \param col col位置
+	 * \return 在cells中的位置
+	 */
+	size_t CellIndex(int, int);
+
+	//儲存格子的連續記憶體 (row-major，外圍多一圈哨兵格子)
+	//cellCapacity為已配置的格子數，Clear後保留，載入不超過這個大小的盤面時不重新配置
+	CellCore* cells = nullptr;
+	size_t cellCapacity = 0;
+
+	//是否已載入
+	bool loaded = false;
+
+	//一個row在記憶體中的長度 (cols + 2)
+	int stride = 0;
+
+	//周遭8格相對於自己的位移量
+	int neighborOffsets[8] = {};
 
 	//row col 數量
 	int rows = 0;
 	int cols = 0;
 
-	//紀錄count的變數
+	//紀錄count的變數，載入時由Refresh計算，之後隨格子狀態改變而增量更新
 	int totalBombCount = 0;
 	int totalFlagCount = 0;
 	int totalBlankCount = 0;
 	int openBlankCount = 0;
 	int remainBlankCount = 0;
+
+	//flood fill使用的工作佇列，由盤面持有並重複使用，避免每次點擊都重新配置記憶體
+	std::vector<size_t> floodQueue;
+
+	//格子變更的紀錄 (nullptr代表不記錄)
+	std::vector<CellChange>* changeLog = nullptr;
+
+	//flood fill的實作方式
+	FloodFillMode floodFillMode = FloodFillMode::QUEUE;
+
+	//bitboard模式使用的平面，第一次使用時才建立，格子被其他方式改變時標記為失效
+	BitBoardCore bitBoard;
+	bool bitBoardReady = false;
+
+	//component模式使用的0區域，載入時建立，炸彈位置改變時標記為失效
+	//componentLabels : 每格所屬的區域編號 (不是0的格子為-1)
+	//componentCells : 依區域排列的格子位置，第k個區域為[componentStarts[k], componentStarts[k + 1])
+	//componentDirty : 區域中是否有0格子被插過旗幟
+	std::vector<int> componentLabels;
+	std::vector<size_t> componentStarts;
+	std::vector<size_t> componentCells;
+	std::vector<char> componentDirty;
+	bool componentsReady = false;
+
+	//RefreshNearBombCount使用的水平炸彈數量buffer (每個tile 5列)，重複使用
+	std::vector<unsigned char> bombSumRows;
+
+	//整盤加總時每個tile各自的count，以及BuildComponents的union-find與填入格子位置時的游標，重複使用
+	std::vector<int> tileCounts;
+	std::vector<int> componentParents;
+	std::vector<size_t> componentFillPositions;
+
+	//整盤運算最多使用的執行緒數量
+	int threadCount = ThreadPoolCore::HardwareThreadCount();
+
+	//盤面格子數少於此值時不切tile，避免執行緒的額外開銷
+	static const int PARALLEL_MIN_CELLS = 1 << 16;
+
+	//隨機產生炸彈時每個block的列數 (與執行緒數量無關)
+	static const int GENERATE_BLOCK_ROWS = 64;
+
+	//RandomRate抽樣比例不超過此值時，使用幾何分佈跳躍，否則逐格抽樣
+	static constexpr double GEOMETRIC_SKIP_MAX_RATE = 0.2;
+
+	//RandomCount使用的隨機數串流編號 (與RandomRate的block編號錯開)
+	static const std::uint64_t RANDOM_COUNT_STREAM = 0xC0FFEEULL << 32;
+
+	//第一次點擊搬移炸彈時使用的隨機數串流編號
+	static const std::uint64_t FIRST_CLICK_STREAM = 0xF125ULL << 32;
+
+	//隨機挑選搬移目標時，每顆炸彈最多嘗試的次數，失敗時改為依序尋找
+	static const int RELOCATE_MAX_ATTEMPTS = 64;
 };
 
 
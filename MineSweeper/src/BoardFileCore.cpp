@@ -0,0 +1,586 @@
+﻿/*****************************************************************//**
+ * File : BoardFileCore.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api implementation of MineSweeperExample
+ *********************************************************************/
+
+#include "BoardFileCore.h"
+
+#include <climits>
+
+//依照編譯目標選擇SIMD指令集，都不支援時使用純量版本
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BOARDFILECORE_USE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BOARDFILECORE_USE_SSE2
+#endif
+
+using namespace std;
+
+//二進位盤面檔的magic
+static const char BINARY_MAGIC[4] = { 'M', 'S', 'B', 'B' };
+
+/**
+ * Intent : 把一段O/X字元分類成格子的byte (X為炸彈，O為空白，皆為關閉狀態)，遇到其他字元時停止
+ *          一次比較一整個向量的字元，全部合法時直接寫入
+ * Pre : text與cellBytes都至少有count個byte
+ * Post :
+ * \param text 字元起始位置
+ * \param cellBytes 輸出的格子byte
+ * \param count 字元數量
+ * \return 第一個不合法字元的位置，全部合法時為count
+ */
+static int ClassifyCells(const unsigned char* text, unsigned char* cellBytes, int count)
+{
+	int j = 0;
+#if defined(BOARDFILECORE_USE_AVX2)
+	const __m256i bombChar = _mm256_set1_epi8('X');
+	const __m256i blankChar = _mm256_set1_epi8('O');
+	const __m256i bombMask = _mm256_set1_epi8(CellCore::BOMB_MASK);
+	for (; j + 32 <= count; j += 32)
+	{
+		__m256i chars = _mm256_loadu_si256((const __m256i*)(text + j));
+		__m256i isBomb = _mm256_cmpeq_epi8(chars, bombChar);
+		__m256i isValid = _mm256_or_si256(isBomb, _mm256_cmpeq_epi8(chars, blankChar));
+		unsigned int validBits = (unsigned int)_mm256_movemask_epi8(isValid);
+		if (validBits != 0xFFFFFFFFu)
+		{
+			break;
+		}
+		_mm256_storeu_si256((__m256i*)(cellBytes + j), _mm256_and_si256(isBomb, bombMask));
+	}
+#elif defined(BOARDFILECORE_USE_SSE2)
+	const __m128i bombChar = _mm_set1_epi8('X');
+	const __m128i blankChar = _mm_set1_epi8('O');
+	const __m128i bombMask = _mm_set1_epi8(CellCore::BOMB_MASK);
+	for (; j + 16 <= count; j += 16)
+	{
+		__m128i chars = _mm_loadu_si128((const __m128i*)(text + j));
+		__m128i isBomb = _mm_cmpeq_epi8(chars, bombChar);
+		__m128i isValid = _mm_or_si128(isBomb, _mm_cmpeq_epi8(chars, blankChar));
+		if (_mm_movemask_epi8(isValid) != 0xFFFF)
+		{
+			break;
+		}
+		_mm_storeu_si128((__m128i*)(cellBytes + j), _mm_and_si128(isBomb, bombMask));
+	}
+#endif
+	//剩下不足一個向量長度的字元，或是含有不合法字元的向量
+	for (; j < count; j++)
+	{
+		if (text[j] == 'X')
+		{
+			cellBytes[j] = CellCore::BOMB_MASK;
+		}
+		else if (text[j] == 'O')
+		{
+			cellBytes[j] = 0;
+		}
+		else
+		{
+			return j;
+		}
+	}
+	return count;
+}
+
+/**
+ * Intent : 找出這一行的結尾 (不含換行字元，CRLF的CR也不算在內)
+ * Pre :
+ * Post :
+ * \param position 行首
+ * \param end 檔案結尾
+ * \return 行尾
+ */
+static const unsigned char* FindLineEnd(const unsigned char* position, const unsigned char* end)
+{
+	//空檔案時data為nullptr，不能交給memchr
+	if (position >= end)
+	{
+		return end;
+	}
+	const unsigned char* newline = static_cast<const unsigned char*>(memchr(position, '\n', end - position));
+	const unsigned char* lineEnd = newline != nullptr ? newline : end;
+	if (lineEnd > position && lineEnd[-1] == '\r')
+	{
+		lineEnd--;
+	}
+	return lineEnd;
+}
+
+/**
+ * Intent : 由行尾移到下一行的行首
+ * Pre : lineEnd由FindLineEnd取得
+ * Post :
+ * \param lineEnd 行尾
+ * \param end 檔案結尾
+ * \return 下一行的行首 (沒有下一行時為end)
+ */
+static const unsigned char* NextLine(const unsigned char* lineEnd, const unsigned char* end)
+{
+	if (lineEnd < end && *lineEnd == '\r')
+	{
+		lineEnd++;
+	}
+	return lineEnd < end ? lineEnd + 1 : end;
+}
+
+/**
+ * Intent : 跳過同一行內的空白字元 (與stream的>>相同的空白字元，換行除外)
+ * Pre :
+ * Post :
+ * \param position 起始位置
+ * \param lineEnd 行尾
+ * \return 第一個不是空白的位置
+ */
+static const unsigned char* SkipBlanks(const unsigned char* position, const unsigned char* lineEnd)
+{
+	while (position < lineEnd && (*position == ' ' || *position == '\t' || *position == '\r' || *position == '\v' || *position == '\f'))
+	{
+		position++;
+	}
+	return position;
+}
+
+/**
+ * Intent : 讀取一個正整數
+ * Pre :
+ * Post : 成功時position移到數字之後
+ * \param position 起始位置
+ * \param lineEnd 行尾
+ * \param value 輸出的數值
+ * \return 是否成功 (沒有數字、為0或超過int範圍時失敗)
+ */
+static bool ParsePositiveInt(const unsigned char*& position, const unsigned char* lineEnd, long long& value)
+{
+	const unsigned char* cursor = position;
+	value = 0;
+	while (cursor < lineEnd && *cursor >= '0' && *cursor <= '9')
+	{
+		value = value * 10 + (*cursor - '0');
+		if (value > INT_MAX)
+		{
+			return false;
+		}
+		cursor++;
+	}
+	if (cursor == position || value == 0)
+	{
+		return false;
+	}
+	position = cursor;
+	return true;
+}
+
+/**
+ * Intent : 錯誤訊息的位置前綴
+ * Pre :
+ * Post :
+ * \param line 行號 (由1開始)
+ * \param column 欄位 (由1開始)
+ * \return "line L, column C: "
+ */
+static string LocationString(long long line, long long column)
+{
+	return "line " + to_string(line) + ", column " + to_string(column) + ": ";
+}
+
+/**
+ * Intent : 錯誤訊息中顯示的字元，不可見的字元以16進位表示
+ * Pre :
+ * Post :
+ * \param value 字元
+ * \return 'A' 或 0x0D 形式的字串
+ */
+static string CharString(unsigned char value)
+{
+	if (value >= 0x20 && value < 0x7F)
+	{
+		return string("'") + (char)value + "'";
+	}
+	const char digits[] = "0123456789ABCDEF";
+	return string("0x") + digits[value >> 4] + digits[value & 0x0F];
+}
+
+/**
+ * Intent : 檔案內容是否為二進位盤面檔 (以magic判斷)
+ * Pre :
+ * Post :
+ * \param data 檔案內容
+ * \param size 檔案大小
+ * \return 是否為二進位盤面檔
+ */
+bool BoardFileCore::IsBinaryBoard(const unsigned char* data, size_t size)
+{
+	return size >= HEADER_SIZE && memcmp(data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0;
+}
+
+/**
+ * Intent : 由映射到記憶體的二進位盤面檔載入盤面，有數字平面時不重新計算數字
+ * Pre : data為8 byte對齊
+ * Post : 成功時載入完成
+ * \param data 檔案內容
+ * \param size 檔案大小
+ * \param board 要載入的盤面
+ * \param seed 輸出檔案中記錄的隨機種子
+ * \return 是否成功 (header不合法、大小不符或checksum錯誤時失敗)
+ */
+bool BoardFileCore::LoadBinaryBoard(const unsigned char* data, size_t size, BoardCore& board, std::uint64_t& seed)
+{
+	//防呆機制
+	if (!IsBinaryBoard(data, size))
+	{
+		return false;
+	}
+
+	std::uint32_t version, flags;
+	std::int32_t rows, cols;
+	std::uint64_t fileSeed, checksum;
+	memcpy(&version, data + 4, 4);
+	memcpy(&rows, data + 8, 4);
+	memcpy(&cols, data + 12, 4);
+	memcpy(&fileSeed, data + 16, 8);
+	memcpy(&flags, data + 24, 4);
+	memcpy(&checksum, data + 32, 8);
+
+	//防呆機制 : 格子數量要能以int表示
+	if (version != FORMAT_VERSION || (flags & ~HAS_COUNTS) != 0 || rows <= 0 || cols <= 0 || (long long)rows * cols > INT_MAX)
+	{
+		return false;
+	}
+
+	//檔案大小必須剛好是header加上平面
+	size_t bombBytes, countBytes;
+	PlaneSizes(rows, cols, bombBytes, countBytes);
+	bool hasCounts = (flags & HAS_COUNTS) != 0;
+	size_t payloadSize = bombBytes + (hasCounts ? countBytes : 0);
+	if (size != HEADER_SIZE + payloadSize)
+	{
+		return false;
+	}
+
+	const unsigned char* payload = data + HEADER_SIZE;
+	if (Checksum(payload, payloadSize) != checksum)
+	{
+		return false;
+	}
+
+	//平面直接由映射的記憶體展開到盤面，不經過任何暫存buffer
+	const std::uint64_t* bombPlane = reinterpret_cast<const std::uint64_t*>(payload);
+	const unsigned char* countPlane = hasCounts ? payload + bombBytes : nullptr;
+	board.LoadPlanes(bombPlane, countPlane, rows, cols);
+
+	seed = fileSeed;
+	return true;
+}
+
+/**
+ * Intent : 由映射到記憶體的文字格式盤面檔載入盤面，每列以SIMD一次分類多個字元並直接寫入盤面
+ *          與舊版的>>相同，格子之間、列與列之間的空白與空白行都會被略過，連續的格子才交給SIMD分類
+ *          接受LF與CRLF換行，最後一列可以沒有換行
+ * Pre :
+ * Post : 成功時載入完成
+ * \param data 檔案內容
+ * \param size 檔案大小
+ * \param board 要載入的盤面
+ * \param error 失敗時輸出錯誤位置與原因 (例如 "line 3, column 5: unexpected character 'A'")
+ * \return 是否成功
+ */
+bool BoardFileCore::LoadTextBoard(const unsigned char* data, size_t size, BoardCore& board, std::string& error)
+{
+	const unsigned char* end = data + size;
+	const unsigned char* position = data;
+	long long line = 1;
+
+	//第一行 : rows cols
+	long long rows = 0, cols = 0;
+	const unsigned char* lineEnd = FindLineEnd(position, end);
+	const unsigned char* cursor = SkipBlanks(position, lineEnd);
+	if (!ParsePositiveInt(cursor, lineEnd, rows) || (cursor = SkipBlanks(cursor, lineEnd), !ParsePositiveInt(cursor, lineEnd, cols)))
+	{
+		error = LocationString(line, cursor - position + 1) + "expected positive row and col counts";
+		return false;
+	}
+	cursor = SkipBlanks(cursor, lineEnd);
+	if (cursor != lineEnd)
+	{
+		error = LocationString(line, cursor - position + 1) + "unexpected character " + CharString(*cursor) + " after col count";
+		return false;
+	}
+
+	//防呆機制 : 格子數量要能以int表示
+	if (rows * cols > INT_MAX)
+	{
+		error = LocationString(line, 1) + "board is too large (" + to_string(rows) + " x " + to_string(cols) + ")";
+		return false;
+	}
+
+	//目前所在的行 : 行首 (計算欄位用) 與行尾
+	const unsigned char* lineStart = position;
+	auto nextLine = [&]()
+	{
+		position = NextLine(lineEnd, end);
+		lineStart = position;
+		lineEnd = FindLineEnd(position, end);
+		line++;
+	};
+	nextLine();
+
+	//每列cols個O/X，分類結果直接寫成格子的byte
+	bool loaded = board.LoadRows((int)rows, (int)cols, [&](int row, unsigned char* cellBytes)
+	{
+		int filled = 0;
+		while (filled < cols)
+		{
+			//略過格子之間與列之間的空白，行尾時換到下一行
+			position = SkipBlanks(position, lineEnd);
+			if (position == lineEnd)
+			{
+				if (position >= end)
+				{
+					error = LocationString(line, position - lineStart + 1) + "expected " + to_string(rows) + " rows of " + to_string(cols)
+						+ " cells, found " + to_string(row) + " rows and " + to_string(filled) + " cells";
+					return false;
+				}
+				nextLine();
+				continue;
+			}
+
+			int count = (int)min((long long)(lineEnd - position), cols - filled);
+			int classified = ClassifyCells(position, cellBytes + filled, count);
+			filled += classified;
+			position += classified;
+			if (classified < count && SkipBlanks(position, lineEnd) == position)
+			{
+				error = LocationString(line, position - lineStart + 1) + "unexpected character " + CharString(*position) + ", expected 'O' or 'X'";
+				return false;
+			}
+		}
+
+		//一列結束後，同一行剩下的部分只能是空白
+		cursor = SkipBlanks(position, lineEnd);
+		if (cursor != lineEnd)
+		{
+			error = LocationString(line, cursor - lineStart + 1) + "expected " + to_string(cols) + " cells, found more";
+			return false;
+		}
+		nextLine();
+		return true;
+	});
+
+	if (!loaded)
+	{
+		return false;
+	}
+
+	//最後一列之後只能有空白行
+	while (position < end)
+	{
+		cursor = SkipBlanks(position, lineEnd);
+		if (cursor != lineEnd)
+		{
+			board.Clear();
+			error = LocationString(line, cursor - lineStart + 1) + "unexpected data after the last row";
+			return false;
+		}
+		nextLine();
+	}
+
+	return true;
+}
+
+/**
+ * Intent : 將盤面寫成二進位盤面檔
+ * Pre : 盤面已載入
+ * Post : 寫入完成
+ * \param filename 輸出檔名
+ * \param board 要寫入的盤面
+ * \param seed 要記錄的隨機種子 (文字盤面為0)
+ * \param withCounts 是否一併寫入數字平面
+ * \return 是否成功
+ */
+bool BoardFileCore::SaveBinaryBoard(std::string filename, BoardCore& board, std::uint64_t seed, bool withCounts)
+{
+	std::int32_t rows = board.GetRowCount();
+	std::int32_t cols = board.GetColCount();
+
+	//防呆機制
+	if (!board.IsLoaded() || rows <= 0 || cols <= 0)
+	{
+		return false;
+	}
+
+	//payload以word配置，炸彈平面對齊8 byte
+	size_t bombBytes, countBytes;
+	PlaneSizes(rows, cols, bombBytes, countBytes);
+	size_t payloadSize = bombBytes + (withCounts ? countBytes : 0);
+	vector<std::uint64_t> payloadWords((payloadSize + 7) / 8, 0);
+	unsigned char* payload = reinterpret_cast<unsigned char*>(payloadWords.data());
+	board.StorePlanes(payloadWords.data(), withCounts ? payload + bombBytes : nullptr);
+
+	unsigned char header[HEADER_SIZE] = {};
+	std::uint32_t version = FORMAT_VERSION;
+	std::uint32_t flags = withCounts ? HAS_COUNTS : 0;
+	std::uint64_t checksum = Checksum(payload, payloadSize);
+	memcpy(header, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+	memcpy(header + 4, &version, 4);
+	memcpy(header + 8, &rows, 4);
+	memcpy(header + 12, &cols, 4);
+	memcpy(header + 16, &seed, 8);
+	memcpy(header + 24, &flags, 4);
+	memcpy(header + 32, &checksum, 8);
+
+	std::ofstream outputFile(filename, std::ios::binary);
+	if (!outputFile.is_open())
+	{
+		return false;
+	}
+	outputFile.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+	outputFile.write(reinterpret_cast<const char*>(payload), payloadSize);
+	return (bool)outputFile;
+}
+
+/**
+ * Intent : 將盤面寫成文字格式的盤面檔
+ * Pre : 盤面已載入
+ * Post : 寫入完成
+ * \param filename 輸出檔名
+ * \param board 要寫入的盤面
+ * \return 是否成功
+ */
+bool BoardFileCore::SaveTextBoard(std::string filename, BoardCore& board)
+{
+	int rows = board.GetRowCount();
+	int cols = board.GetColCount();
+
+	//防呆機制
+	if (!board.IsLoaded() || rows <= 0 || cols <= 0)
+	{
+		return false;
+	}
+
+	std::ofstream outputFile(filename, std::ios::binary);
+	if (!outputFile.is_open())
+	{
+		return false;
+	}
+
+	//與內附的盤面檔相同 : 第一行為rows cols，之後每列一行，最後一行沒有換行
+	outputFile << rows << ' ' << cols;
+	string line(cols, 'O');
+	for (int i = 0; i < rows; i++)
+	{
+		for (int j = 0; j < cols; j++)
+		{
+			line[j] = board.GetCell(i, j)->IsBomb() ? 'X' : 'O';
+		}
+		outputFile << '\n' << line;
+	}
+	return (bool)outputFile;
+}
+
+/**
+ * Intent : 轉換盤面檔格式，文字格式轉成二進位 (含數字平面)，二進位轉成文字格式
+ * Pre :
+ * Post : 轉換完成
+ * \param inputFilename 輸入檔名
+ * \param outputFilename 輸出檔名
+ * \return 是否成功
+ */
+bool BoardFileCore::ConvertBoard(std::string inputFilename, std::string outputFilename)
+{
+	BoardCore board;
+	MappedFileCore inputFile;
+
+	if (!inputFile.Open(inputFilename))
+	{
+		return false;
+	}
+
+	if (IsBinaryBoard(inputFile.GetData(), inputFile.GetSize()))
+	{
+		std::uint64_t seed = 0;
+		if (!LoadBinaryBoard(inputFile.GetData(), inputFile.GetSize(), board, seed))
+		{
+			return false;
+		}
+		inputFile.Close();
+		return SaveTextBoard(outputFilename, board);
+	}
+
+	string error;
+	if (!LoadTextBoard(inputFile.GetData(), inputFile.GetSize(), board, error))
+	{
+		cerr << inputFilename << ": " << error << endl;
+		return false;
+	}
+	inputFile.Close();
+	return SaveBinaryBoard(outputFilename, board, 0, true);
+}
+
+/**
+ * Intent : 計算payload的checksum，每個word各自以位置混合後加總，可以分block平行計算
+ * Pre :
+ * Post :
+ * \param data payload起始位置
+ * \param size payload大小
+ * \return checksum
+ */
+std::uint64_t BoardFileCore::Checksum(const unsigned char* data, size_t size)
+{
+	//加法可以交換順序，所以每個block各自加總後再合併，結果與執行緒數量無關
+	const std::uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+	size_t wordCount = size / 8;
+	int blockCount = (int)((size + CHECKSUM_BLOCK_SIZE - 1) / CHECKSUM_BLOCK_SIZE);
+	vector<std::uint64_t> blockSums(max(blockCount, 1), 0);
+
+	ThreadPoolCore::Instance().Run(blockCount, [&](int block)
+	{
+		size_t beginWord = (size_t)block * (CHECKSUM_BLOCK_SIZE / 8);
+		size_t endWord = min(beginWord + CHECKSUM_BLOCK_SIZE / 8, wordCount);
+		std::uint64_t sum = 0;
+		for (size_t w = beginWord; w < endWord; w++)
+		{
+			std::uint64_t word;
+			memcpy(&word, data + w * 8, 8);
+			sum += RandomCore::Mix(word ^ (w * GOLDEN_GAMMA));
+		}
+		blockSums[block] = sum;
+	}, ThreadPoolCore::HardwareThreadCount());
+
+	std::uint64_t total = 0;
+	for (std::uint64_t blockSum : blockSums)
+	{
+		total += blockSum;
+	}
+
+	//最後不足一個word的byte補0
+	if (size % 8 != 0)
+	{
+		std::uint64_t word = 0;
+		memcpy(&word, data + wordCount * 8, size % 8);
+		total += RandomCore::Mix(word ^ (wordCount * GOLDEN_GAMMA));
+	}
+
+	return RandomCore::Mix(total ^ (std::uint64_t)size);
+}
+
+/**
+ * Intent : 由rows cols計算炸彈平面與數字平面的大小
+ * Pre : rows cols大於0
+ * Post :
+ * \param rows row數量
+ * \param cols col數量
+ * \param bombBytes 輸出炸彈平面的大小
+ * \param countBytes 輸出數字平面的大小
+ */
+void BoardFileCore::PlaneSizes(int rows, int cols, size_t& bombBytes, size_t& countBytes)
+{
+	bombBytes = (size_t)rows * (((size_t)cols + 63) / 64) * sizeof(std::uint64_t);
+	countBytes = (size_t)rows * (((size_t)cols + 1) / 2);
+}
@@ -0,0 +1,140 @@
+﻿/*****************************************************************//**
+ * File : BoardFileCore.h
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api header of MineSweeperExample
+ *********************************************************************/
+
+#pragma once
+#ifndef _BOARDFILECORE_H_
+#define _BOARDFILECORE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "BoardCore.h"
+#include "MappedFileCore.h"
+#include "RandomCore.h"
+#include "ThreadPoolCore.h"
+
+//盤面檔的讀寫，支援原本的文字格式 (rows cols 之後每列一行O/X) 與二進位格式
+//二進位格式 (little-endian) :
+//  header (HEADER_SIZE byte) : magic "MSBB"、版本、rows、cols、seed、flags、payload的checksum
+//  炸彈平面 : 每列 (cols + 63) / 64 個64bit word，第j格為第 j / 64 個word的第 j % 64 個bit
+//  數字平面 (flags有HAS_COUNTS時才有) : 每列 (cols + 1) / 2 個byte，每格4bit，偶數col在低位
+//header的大小是8的倍數，檔案映射到記憶體後炸彈平面可以直接當成word陣列使用，不需要解析
+class BoardFileCore
+{
+public:
+
+	/**
+	 * Intent : 檔案內容是否為二進位盤面檔 (以magic判斷)
+	 * Pre :
+	 * Post :
+	 * \param data 檔案內容
+	 * \param size 檔案大小
+	 * \return 是否為二進位盤面檔
+	 */
+	static bool IsBinaryBoard(const unsigned char*, size_t);
+
+	/**
+	 * Intent : 由映射到記憶體的二進位盤面檔載入盤面，有數字平面時不重新計算數字
+	 * Pre : data為8 byte對齊
+	 * Post : 成功時載入完成
+	 * \param data 檔案內容
+	 * \param size 檔案大小
+	 * \param board 要載入的盤面
+	 * \param seed 輸出檔案中記錄的隨機種子
+	 * \return 是否成功 (header不合法、大小不符或checksum錯誤時失敗)
+	 */
+	static bool LoadBinaryBoard(const unsigned char*, size_t, BoardCore&, std::uint64_t&);
+
+	/**
+	 * Intent : 由映射到記憶體的文字格式盤面檔載入盤面，每列以SIMD一次分類多個字元並直接寫入盤面
+	 *          與舊版的>>相同，格子之間、列與列之間的空白與空白行都會被略過，連續的格子才交給SIMD分類
+	 *          接受LF與CRLF換行，最後一列可以沒有換行
+	 * Pre :
+	 * Post : 成功時載入完成
+	 * \param data 檔案內容
+	 * \param size 檔案大小
+	 * \param board 要載入的盤面
+	 * \param error 失敗時輸出錯誤位置與原因 (例如 "line 3, column 5: unexpected character 'A'")
+	 * \return 是否成功
+	 */
+	static bool LoadTextBoard(const unsigned char*, size_t, BoardCore&, std::string&);
+
+	/**
+	 * Intent : 將盤面寫成二進位盤面檔
+	 * Pre : 盤面已載入
+	 * Post : 寫入完成
+	 * \param filename 輸出檔名
+	 * \param board 要寫入的盤面
+	 * \param seed 要記錄的隨機種子 (文字盤面為0)
+	 * \param withCounts 是否一併寫入數字平面
+	 * \return 是否成功
+	 */
+	static bool SaveBinaryBoard(std::string, BoardCore&, std::uint64_t, bool);
+
+	/**
+	 * Intent : 將盤面寫成文字格式的盤面檔
+	 * Pre : 盤面已載入
+	 * Post : 寫入完成
+	 * \param filename 輸出檔名
+	 * \param board 要寫入的盤面
+	 * \return 是否成功
+	 */
+	static bool SaveTextBoard(std::string, BoardCore&);
+
+	/**
+	 * Intent : 轉換盤面檔格式，文字格式轉成二進位 (含數字平面)，二進位轉成文字格式
+	 * Pre :
+	 * Post : 轉換完成
+	 * \param inputFilename 輸入檔名
+	 * \param outputFilename 輸出檔名
+	 * \return 是否成功
+	 */
+	static bool ConvertBoard(std::string, std::string);
+
+	/**
+	 * Intent : 計算payload的checksum，每個word各自以位置混合後加總，可以分block平行計算
+	 * Pre :
+	 * Post :
+	 * \param data payload起始位置
+	 * \param size payload大小
+	 * \return checksum
+	 */
+	static std::uint64_t Checksum(const unsigned char*, size_t);
+
+	//header的大小
+	static const size_t HEADER_SIZE = 40;
+
+	//目前的格式版本
+	static const std::uint32_t FORMAT_VERSION = 1;
+
+	//flags : 是否含有數字平面
+	static const std::uint32_t HAS_COUNTS = 0x1;
+
+private:
+
+	/**
+	 * Intent : 由rows cols計算炸彈平面與數字平面的大小
+	 * Pre : rows cols大於0
+	 * Post :
+	 * \param rows row數量
+	 * \param cols col數量
+	 * \param bombBytes 輸出炸彈平面的大小
+	 * \param countBytes 輸出數字平面的大小
+	 */
+	static void PlaneSizes(int, int, size_t&, size_t&);
+
+	//checksum每個block的大小，block的切法與執行緒數量無關
+	static const size_t CHECKSUM_BLOCK_SIZE = 1 << 20;
+};
+
+#endif // !_BOARDFILECORE_H_
@@ -31,7 +31,7 @@ CellCore::~CellCore()
  */
 bool CellCore::IsBomb()
 {
-	return isBomb;
+	return (data & BOMB_MASK) != 0;
 }
 
 /**
@@ -42,7 +42,7 @@ bool CellCore::IsBomb()
  */
 void CellCore::SetBomb(bool _isBomb)
 {
-	isBomb = _isBomb;
+	data = _isBomb ? (data | BOMB_MASK) : (data & ~BOMB_MASK);
 }
 
 /**
@@ -53,7 +53,7 @@ void CellCore::SetBomb(bool _isBomb)
  */
 CellState CellCore::GetState()
 {
-	return state;
+	return (CellState)((data & STATE_MASK) >> STATE_SHIFT);
 }
 
 /**
@@ -64,17 +64,18 @@ CellState CellCore::GetState()
  */
 void CellCore::SetState(CellState newState)
 {
-	state = newState;
+	data = (data & ~STATE_MASK) | (((unsigned char)newState << STATE_SHIFT) & STATE_MASK);
 }
 
 /**
  * Intent : 印出該格所表示的字元
  * Pre :
  * Post :
+ * \param output 輸出的緩衝區
  */
-void CellCore::Print()
+void CellCore::Print(OutputSinkCore& output)
 {
-	cout << GetChar();
+	output << GetChar();
 }
 
 /**
@@ -85,7 +86,7 @@ void CellCore::Print()
  */
 char CellCore::GetChar()
 {
-	switch (state)
+	switch (GetState())
 	{
 	case CellState::CLOSED:
 		//尚未開啟(關閉)狀態
@@ -93,7 +94,7 @@ char CellCore::GetChar()
 		break;
 	case CellState::OPENED:
 		//已開啟狀態
-		if (isBomb)
+		if (IsBomb())
 		{
 			//若為炸彈
 			return 'X';
@@ -101,7 +102,7 @@ char CellCore::GetChar()
 		else
 		{
 			//若為空白格子，顯示數字(0~9)
-			return nearBombCount + '0';
+			return GetNearBombCount() + '0';
 		}
 		break;
 	case CellState::FLAGGED:
@@ -122,10 +123,22 @@ char CellCore::GetChar()
  * Intent :	印出該格的解答 (炸彈為X 其餘為數字(near bomb count))
  * Pre :
  * Post :
+ * \param output 輸出的緩衝區
  */
-void CellCore::PrintAnswer()
+void CellCore::PrintAnswer(OutputSinkCore& output)
 {
-	cout << (isBomb ? "X" : to_string(nearBombCount));
+	output << GetAnswerChar();
+}
+
+/**
+ * Intent :	獲取該格的解答字元 (炸彈為X 其餘為數字(near bomb count))
+ * Pre :
+ * Post :
+ * \return 該格的解答字元
+ */
+char CellCore::GetAnswerChar()
+{
+	return IsBomb() ? 'X' : (char)(GetNearBombCount() + '0');
 }
 
 /**
@@ -136,7 +149,7 @@ void CellCore::PrintAnswer()
  */
 int CellCore::GetNearBombCount()
 {
-	return nearBombCount;
+	return (data & COUNT_MASK) >> COUNT_SHIFT;
 }
 
 /**
@@ -147,9 +160,10 @@ int CellCore::GetNearBombCount()
  */
 void CellCore::SetNearBombCount(int _nearBombCount)
 {
-	if (_nearBombCount >= 0)
+	//周遭最多只有8顆炸彈，4個bit就放得下
+	if (_nearBombCount >= 0 && _nearBombCount <= 8)
 	{
-		nearBombCount = _nearBombCount;
+		data = (data & ~COUNT_MASK) | (unsigned char)(_nearBombCount << COUNT_SHIFT);
 	}
 }
 
@@ -161,6 +175,7 @@ void CellCore::SetNearBombCount(int _nearBombCount)
  */
 bool CellCore::CanBeLeftClick()
 {
+	CellState state = GetState();
 	return state == CellState::CLOSED || state == CellState::QUESTION_MARK;
 }
 
@@ -172,6 +187,7 @@ bool CellCore::CanBeLeftClick()
  */
 bool CellCore::CanBeRightClick()
 {
+	CellState state = GetState();
 	return state == CellState::CLOSED || state == CellState::FLAGGED || state == CellState::QUESTION_MARK;
 }
 
@@ -183,18 +199,18 @@ bool CellCore::CanBeRightClick()
 void CellCore::RightClick()
 {
 	if (!CanBeRightClick()) return;
-	switch (state)
+	switch (GetState())
 	{
 	case CellState::CLOSED:
-		state = CellState::FLAGGED;
+		SetState(CellState::FLAGGED);
 		break;
 	case CellState::OPENED:
 		break;
 	case CellState::FLAGGED:
-		state = CellState::QUESTION_MARK;
+		SetState(CellState::QUESTION_MARK);
 		break;
 	case CellState::QUESTION_MARK:
-		state = CellState::CLOSED;
+		SetState(CellState::CLOSED);
 		break;
 	default:
 		break;
@@ -14,6 +14,8 @@
 #include <iostream>
 #include <string>
 
+#include "OutputSinkCore.h"
+
  //列舉出格子的顯示狀態
 enum class CellState
 {
@@ -23,6 +25,13 @@ enum class CellState
 	QUESTION_MARK, //標記問號
 };
 
+//被點擊改變顯示狀態的格子位置 (二進位協定回傳變更的格子時使用)
+struct CellChange
+{
+	long long row;
+	long long col;
+};
+
 class CellCore
 {
 public:
@@ -69,8 +78,9 @@ public:
 	 * Intent : 印出該格所表示的字元
 	 * Pre :
 	 * Post :
+	 * \param output 輸出的緩衝區
 	 */
-	void Print();
+	void Print(OutputSinkCore&);
 
 	/**
 	 * Intent : 獲取該格所表示的字元
@@ -84,8 +94,17 @@ public:
 	 * Intent :	印出該格的解答 (炸彈為X 其餘為數字(near bomb count))
 	 * Pre :
 	 * Post :
+	 * \param output 輸出的緩衝區
+	 */
+	void PrintAnswer(OutputSinkCore&);
+
+	/**
+	 * Intent :	獲取該格的解答字元 (炸彈為X 其餘為數字(near bomb count))
+	 * Pre :
+	 * Post :
+	 * \return 該格的解答字元
 	 */
-	void PrintAnswer();
+	char GetAnswerChar();
 
 	/**
 	 * Intent :	回傳周遭九宮格內的炸彈數量
@@ -126,16 +145,20 @@ public:
 	 */
 	void RightClick();
 
-private:
-
-	//是否為炸彈
-	bool isBomb = false;
+	//將所有資訊壓縮在1個byte中，BoardCore的整列kernel會直接依照此格式操作記憶體
+	//bit 0 : 是否為炸彈
+	//bit 1~2 : 格子顯示狀態 (CellState)
+	//bit 3~6 : 周遭九宮格內的炸彈數量 (0~8)
+	static const unsigned char BOMB_MASK = 0x01;
+	static const unsigned char STATE_SHIFT = 1;
+	static const unsigned char STATE_MASK = 0x03 << STATE_SHIFT;
+	static const unsigned char COUNT_SHIFT = 3;
+	static const unsigned char COUNT_MASK = 0x0F << COUNT_SHIFT;
 
-	//格子顯示狀態
-	CellState state = CellState::CLOSED;
+private:
 
-	//周遭九宮格內的炸彈數量
-	int nearBombCount = 0;
+	//壓縮後的格子資訊 (預設 : 非炸彈、未打開、數量為0)
+	unsigned char data = 0;
 };
 
 
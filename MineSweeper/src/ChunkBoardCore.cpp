@@ -0,0 +1,728 @@
+﻿/*****************************************************************//**
+ * File : ChunkBoardCore.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api implementation of MineSweeperExample
+ *********************************************************************/
+
+#include "ChunkBoardCore.h"
+
+using namespace std;
+
+//ChunkBoardCore constructor
+ChunkBoardCore::ChunkBoardCore()
+{
+
+}
+
+//ChunkBoardCore destructor
+ChunkBoardCore::~ChunkBoardCore()
+{
+	Clear();
+}
+
+/**
+ * Intent : 載入沒有邊界的盤面 (不配置任何區塊)
+ * Pre :
+ * Post : 載入完成
+ * \param _bombRate 每格的炸彈生成機率
+ * \param _seed 隨機種子
+ */
+void ChunkBoardCore::Load(float _bombRate, std::uint64_t _seed)
+{
+	Clear();
+	bombRate = _bombRate;
+	seed = _seed;
+	loaded = true;
+}
+
+/**
+ * Intent :	清除已有資訊，區塊記憶體保留給下一次載入重複使用
+ * Pre :
+ * Post : 未載入狀態
+ */
+void ChunkBoardCore::Clear()
+{
+	chunkCount = 0;
+	for (ChunkSlot& slot : chunkTable)
+	{
+		slot.chunk = nullptr;
+	}
+	lastChunk = nullptr;
+	minChunkRow = 0;
+	maxChunkRow = -1;
+	minChunkCol = 0;
+	maxChunkCol = -1;
+	totalBombCount = 0;
+	totalFlagCount = 0;
+	openBlankCount = 0;
+	loaded = false;
+}
+
+/**
+ * Intent : 釋放保留的區塊記憶體
+ * Pre : 未載入 (Clear之後)
+ * Post : 保留的記憶體超過maxBytes時全部釋放
+ * \param maxBytes 可以保留的記憶體上限 (byte)
+ */
+void ChunkBoardCore::ShrinkMem(size_t maxBytes)
+{
+	if (loaded || GetRetainedMemorySize() <= maxBytes)
+	{
+		return;
+	}
+
+	vector<unique_ptr<Chunk>>().swap(chunkStorage);
+	vector<ChunkSlot>().swap(chunkTable);
+	vector<pair<long long, long long>>().swap(floodQueue);
+}
+
+/**
+ * Intent : 回傳區塊、hash表與flood fill佇列保留的記憶體大小 (含未使用的容量)
+ * Pre :
+ * Post :
+ * \return 保留的byte數
+ */
+size_t ChunkBoardCore::GetRetainedMemorySize() const
+{
+	return chunkStorage.size() * sizeof(Chunk) + chunkStorage.capacity() * sizeof(unique_ptr<Chunk>)
+		+ chunkTable.capacity() * sizeof(ChunkSlot) + floodQueue.capacity() * sizeof(floodQueue[0]);
+}
+
+/**
+ * Intent : 是否已載入過盤面
+ * Pre :
+ * Post :
+ * \return 是否已載入過盤面
+ */
+bool ChunkBoardCore::IsLoaded()
+{
+	return loaded;
+}
+
+/**
+ * Intent : 印出盤面的一個範圍，範圍內的區塊會被產生
+ * Pre :
+ * Post :
+ * \param output 輸出的緩衝區
+ * \param top 範圍的第一個row
+ * \param left 範圍的第一個col
+ * \param rowCount 範圍的row數量
+ * \param colCount 範圍的col數量
+ * \param rowSplit row與row之間的分隔字串
+ * \param colSplit col與col之間的分隔字串
+ */
+void ChunkBoardCore::Print(OutputSinkCore& output, long long top, long long left, long long rowCount, long long colCount, std::string rowSplit, std::string colSplit)
+{
+	for (long long i = 0; i < rowCount; i++)
+	{
+		for (long long j = 0; j < colCount; j++)
+		{
+			GetCell(top + i, left + j)->Print(output);
+			output << colSplit;
+		}
+		output << rowSplit;
+	}
+}
+
+/**
+ * Intent : 印出盤面一個範圍的解答 (含炸彈位置與每格數字)，範圍內的區塊會被產生
+ * Pre :
+ * Post :
+ * \param output 輸出的緩衝區
+ * \param top 範圍的第一個row
+ * \param left 範圍的第一個col
+ * \param rowCount 範圍的row數量
+ * \param colCount 範圍的col數量
+ * \param rowSplit row與row之間的分隔字串
+ * \param colSplit col與col之間的分隔字串
+ */
+void ChunkBoardCore::PrintAnswer(OutputSinkCore& output, long long top, long long left, long long rowCount, long long colCount, std::string rowSplit, std::string colSplit)
+{
+	for (long long i = 0; i < rowCount; i++)
+	{
+		for (long long j = 0; j < colCount; j++)
+		{
+			GetCell(top + i, left + j)->PrintAnswer(output);
+			output << colSplit;
+		}
+		output << rowSplit;
+	}
+}
+
+/**
+ * Intent : 回傳已計算好數字的區塊所涵蓋的範圍 (探索過的範圍)
+ * Pre :
+ * Post :
+ * \param top 輸出範圍的第一個row
+ * \param left 輸出範圍的第一個col
+ * \param rowCount 輸出範圍的row數量
+ * \param colCount 輸出範圍的col數量
+ * \return 是否有探索過的範圍
+ */
+bool ChunkBoardCore::GetExploredRange(long long& top, long long& left, long long& rowCount, long long& colCount)
+{
+	if (maxChunkRow < minChunkRow)
+	{
+		return false;
+	}
+
+	top = minChunkRow * CHUNK_SIZE;
+	left = minChunkCol * CHUNK_SIZE;
+
+	//兩端都在座標上限附近時，格子數量會超過long long，以COORD_LIMIT表示
+	long long chunkRows = maxChunkRow - minChunkRow + 1;
+	long long chunkCols = maxChunkCol - minChunkCol + 1;
+	rowCount = chunkRows > COORD_LIMIT / CHUNK_SIZE ? COORD_LIMIT : chunkRows * CHUNK_SIZE;
+	colCount = chunkCols > COORD_LIMIT / CHUNK_SIZE ? COORD_LIMIT : chunkCols * CHUNK_SIZE;
+	return true;
+}
+
+/**
+ * Intent : 獲取該格的指標，該格所在的區塊與周遭的區塊會被產生，數字已計算完成
+ * Pre :
+ * Post :
+ * \param row row的位置
+ * \param col col的位置
+ * \return 該格的指標，超出範圍時為nullptr
+ */
+CellCore* ChunkBoardCore::GetCell(long long row, long long col)
+{
+	//防呆機制
+	if (!ValidRowCol(row, col))
+	{
+		return nullptr;
+	}
+
+	Chunk* chunk = GetCountedChunk(row >> CHUNK_SHIFT, col >> CHUNK_SHIFT);
+	return &chunk->cells[(row & (CHUNK_SIZE - 1)) * CHUNK_SIZE + (col & (CHUNK_SIZE - 1))];
+}
+
+/**
+ * Intent : 計算該格周遭九宮格內的炸彈數量 (near bomb count)
+ * Pre :
+ * Post :
+ * \param row row位置
+ * \param col col位置
+ * \return 該格周遭九宮格內的炸彈數量
+ */
+int ChunkBoardCore::GetNearBombCount(long long row, long long col)
+{
+	CellCore* cell = GetCell(row, col);
+
+	//防呆機制
+	if (cell == nullptr)
+	{
+		return 0;
+	}
+
+	return cell->GetNearBombCount();
+}
+
+/**
+ * Intent : 從指定格子開始開啟整個區域 (flood fill)，一次最多開啟FLOOD_MAX_CELLS格
+ * Pre : 該格不是炸彈
+ * Post : 該區域內可開啟的格子都被開啟 (超過上限時，剩下的格子保持關閉)
+ * \param row row位置
+ * \param col col位置
+ */
+void ChunkBoardCore::FloodOpen(long long row, long long col)
+{
+	CellCore* cell = GetCell(row, col);
+
+	//只開啟關閉或標註問號的空白格子
+	if (cell == nullptr || !cell->CanBeLeftClick() || cell->IsBomb())
+	{
+		return;
+	}
+
+	OpenCell(cell, row, col);
+
+	//不是0的格子不需要擴散
+	if (cell->GetNearBombCount() != 0)
+	{
+		return;
+	}
+
+	//先進先出的工作佇列，由起點一圈一圈往外擴散，達到上限時開啟的範圍集中在起點附近
+	//周遭格子所在的區塊在存取時才產生
+	long long openedCount = 1;
+	floodQueue.clear();
+	floodQueue.push_back({ row, col });
+	size_t queueHead = 0;
+
+	while (queueHead < floodQueue.size() && openedCount < FLOOD_MAX_CELLS)
+	{
+		long long currentRow = floodQueue[queueHead].first;
+		long long currentCol = floodQueue[queueHead].second;
+		queueHead++;
+
+		for (long long nearRow = currentRow - 1; nearRow <= currentRow + 1; nearRow++)
+		{
+			for (long long nearCol = currentCol - 1; nearCol <= currentCol + 1; nearCol++)
+			{
+				CellCore* nearCell = GetCell(nearRow, nearCol);
+
+				//超出範圍、已開啟、旗幟或炸彈都不能被開啟
+				if (nearCell == nullptr || !nearCell->CanBeLeftClick() || nearCell->IsBomb())
+				{
+					continue;
+				}
+
+				OpenCell(nearCell, nearRow, nearCol);
+				openedCount++;
+
+				//達到上限時立刻停止，開啟的格子數剛好是FLOOD_MAX_CELLS
+				if (openedCount >= FLOOD_MAX_CELLS)
+				{
+					return;
+				}
+
+				//如果該格是0，放入佇列繼續擴散
+				if (nearCell->GetNearBombCount() == 0)
+				{
+					floodQueue.push_back({ nearRow, nearCol });
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Intent : 對該格執行RightClick標註，並同步更新旗幟數量
+ * Pre :
+ * Post : 標註完成
+ * \param row row位置
+ * \param col col位置
+ */
+void ChunkBoardCore::RightClickCell(long long row, long long col)
+{
+	CellCore* cell = GetCell(row, col);
+
+	//防呆機制
+	if (cell == nullptr)
+	{
+		return;
+	}
+
+	CellState oldState = cell->GetState();
+	cell->RightClick();
+	CellState newState = cell->GetState();
+
+	if (changeLog != nullptr)
+	{
+		changeLog->push_back({ row, col });
+	}
+
+	//只有進出旗幟狀態會影響旗幟數量
+	if (oldState != CellState::FLAGGED && newState == CellState::FLAGGED)
+	{
+		totalFlagCount++;
+	}
+	else if (oldState == CellState::FLAGGED && newState != CellState::FLAGGED)
+	{
+		totalFlagCount--;
+	}
+}
+
+/**
+ * Intent : 移除點擊位置周遭九宮格內的炸彈，讓第一次點擊必定安全並開出0
+ *          沒有邊界的盤面沒有固定的炸彈數量，所以不需要搬到別的地方
+ * Pre : 尚未開啟任何格子
+ * Post : 炸彈移除完成，周遭的near bomb count同步更新
+ * \param row 點擊的row位置
+ * \param col 點擊的col位置
+ */
+void ChunkBoardCore::ClearBombsAround(long long row, long long col)
+{
+	for (long long bombRow = row - 1; bombRow <= row + 1; bombRow++)
+	{
+		for (long long bombCol = col - 1; bombCol <= col + 1; bombCol++)
+		{
+			CellCore* cell = GetCell(bombRow, bombCol);
+			if (cell == nullptr || !cell->IsBomb())
+			{
+				continue;
+			}
+
+			cell->SetBomb(false);
+			totalBombCount--;
+
+			//周遭格子所在的區塊都已產生，只有已計算數字的區塊需要更新，其餘的區塊之後會由炸彈重新計算
+			for (long long nearRow = bombRow - 1; nearRow <= bombRow + 1; nearRow++)
+			{
+				for (long long nearCol = bombCol - 1; nearCol <= bombCol + 1; nearCol++)
+				{
+					if ((nearRow == bombRow && nearCol == bombCol) || !ValidRowCol(nearRow, nearCol))
+					{
+						continue;
+					}
+
+					Chunk* chunk = GetChunk(nearRow >> CHUNK_SHIFT, nearCol >> CHUNK_SHIFT);
+					if (chunk->countReady)
+					{
+						CellCore* nearCell = &chunk->cells[(nearRow & (CHUNK_SIZE - 1)) * CHUNK_SIZE + (nearCol & (CHUNK_SIZE - 1))];
+						nearCell->SetNearBombCount(nearCell->GetNearBombCount() - 1);
+					}
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Intent : 把所有已計算好數字的區塊都開啟，遊戲結束顯示解答時使用
+ * Pre :
+ * Post : 探索過的格子都被開啟
+ */
+void ChunkBoardCore::UncoverAll()
+{
+	const unsigned char openedBits = (unsigned char)CellState::OPENED << CellCore::STATE_SHIFT;
+
+	//只產生炸彈、還沒有數字的區塊不開啟，印出時才會以正確的數字顯示
+	for (size_t chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++)
+	{
+		Chunk& chunk = *chunkStorage[chunkIndex];
+		if (!chunk.countReady)
+		{
+			continue;
+		}
+
+		unsigned char* bytes = reinterpret_cast<unsigned char*>(chunk.cells);
+		for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; i++)
+		{
+			bytes[i] = (bytes[i] & ~CellCore::STATE_MASK) | openedBits;
+		}
+	}
+}
+
+/**
+ * Intent :	輸入的row col是否合法 (在座標上限內)
+ * Pre :
+ * Post :
+ * \param row 輸入的row
+ * \param col 輸入的col
+ * \return 輸入的row col是否合法
+ */
+bool ChunkBoardCore::ValidRowCol(long long row, long long col)
+{
+	if (row <= -COORD_LIMIT || row >= COORD_LIMIT)
+	{
+		return false;
+	}
+
+	if (col <= -COORD_LIMIT || col >= COORD_LIMIT)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Intent : 回傳已產生的區塊中的炸彈數量
+ * Pre :
+ * Post :
+ * \return 已產生的區塊中的炸彈數量
+ */
+long long ChunkBoardCore::GetTotalBombCount()
+{
+	return totalBombCount;
+}
+
+/**
+ * Intent : 回傳旗幟總數量
+ * Pre :
+ * Post :
+ * \return 回傳旗幟總數量
+ */
+long long ChunkBoardCore::GetTotalFlagCount()
+{
+	return totalFlagCount;
+}
+
+/**
+ * Intent :	回傳已開啟的空白格子數量
+ * Pre :
+ * Post :
+ * \return 已開啟的空白格子數量
+ */
+long long ChunkBoardCore::GetOpenBlankCount()
+{
+	return openBlankCount;
+}
+
+/**
+ * Intent :	回傳已產生的區塊中，剩餘未開啟的空白格子數量
+ * Pre :
+ * Post :
+ * \return 已產生的區塊中剩餘未開啟的空白格子數量
+ */
+long long ChunkBoardCore::GetRemainBlankCount()
+{
+	return (long long)chunkCount * CHUNK_SIZE * CHUNK_SIZE - totalBombCount - openBlankCount;
+}
+
+/**
+ * Intent : 回傳已配置的區塊數量
+ * Pre :
+ * Post :
+ * \return 已配置的區塊數量
+ */
+long long ChunkBoardCore::GetChunkCount()
+{
+	return (long long)chunkCount;
+}
+
+/**
+ * Intent : 取得區塊，不存在時配置並產生炸彈
+ * Pre :
+ * Post :
+ * \param chunkRow 區塊的row位置
+ * \param chunkCol 區塊的col位置
+ * \return 區塊的指標
+ */
+ChunkBoardCore::Chunk* ChunkBoardCore::GetChunk(long long chunkRow, long long chunkCol)
+{
+	ChunkKey key = { chunkRow, chunkCol };
+	if (lastChunk != nullptr && lastKey == key)
+	{
+		return lastChunk;
+	}
+
+	//表中至少保留一半的空位，線性探測很快就會遇到目標或空位
+	if ((chunkCount + 1) * 2 > chunkTable.size())
+	{
+		GrowChunkTable();
+	}
+
+	size_t mask = chunkTable.size() - 1;
+	size_t slot = ChunkKeyHash()(key) & mask;
+	while (chunkTable[slot].chunk != nullptr && !(chunkTable[slot].key == key))
+	{
+		slot = (slot + 1) & mask;
+	}
+
+	//區塊各自配置，hash表加大時位置不變，指標可以一直使用到Clear為止
+	Chunk* chunk = chunkTable[slot].chunk;
+	if (chunk == nullptr)
+	{
+		chunk = AllocateChunk();
+		chunkTable[slot].key = key;
+		chunkTable[slot].chunk = chunk;
+		GenerateChunk(chunk, chunkRow, chunkCol);
+	}
+
+	lastKey = key;
+	lastChunk = chunk;
+	return chunk;
+}
+
+/**
+ * Intent : 取出一個格子為預設值的區塊 (優先重複使用Clear前配置的區塊)
+ * Pre :
+ * Post : chunkCount加1
+ * \return 區塊的指標
+ */
+ChunkBoardCore::Chunk* ChunkBoardCore::AllocateChunk()
+{
+	if (chunkCount == chunkStorage.size())
+	{
+		chunkStorage.emplace_back(new Chunk());
+		return chunkStorage[chunkCount++].get();
+	}
+
+	//重複使用的區塊還留有上一個盤面的格子，改回預設值 (非炸彈、未打開、數量為0)
+	Chunk* chunk = chunkStorage[chunkCount++].get();
+	memset(reinterpret_cast<unsigned char*>(chunk->cells), 0, sizeof(chunk->cells));
+	chunk->countReady = false;
+	return chunk;
+}
+
+/**
+ * Intent : 把hash表加大一倍，重新放入所有區塊
+ * Pre :
+ * Post :
+ */
+void ChunkBoardCore::GrowChunkTable()
+{
+	vector<ChunkSlot> grown(max(chunkTable.size() * 2, (size_t)64));
+	size_t mask = grown.size() - 1;
+	for (const ChunkSlot& entry : chunkTable)
+	{
+		if (entry.chunk == nullptr)
+		{
+			continue;
+		}
+
+		size_t slot = ChunkKeyHash()(entry.key) & mask;
+		while (grown[slot].chunk != nullptr)
+		{
+			slot = (slot + 1) & mask;
+		}
+		grown[slot] = entry;
+	}
+	chunkTable.swap(grown);
+}
+
+/**
+ * Intent : 取得區塊，並確保near bomb count已計算完成
+ * Pre :
+ * Post :
+ * \param chunkRow 區塊的row位置
+ * \param chunkCol 區塊的col位置
+ * \return 區塊的指標
+ */
+ChunkBoardCore::Chunk* ChunkBoardCore::GetCountedChunk(long long chunkRow, long long chunkCol)
+{
+	Chunk* chunk = GetChunk(chunkRow, chunkCol);
+	if (!chunk->countReady)
+	{
+		CountChunk(chunk, chunkRow, chunkCol);
+
+		//CountChunk會存取周遭的區塊，把最近一次存取的區塊改回自己
+		lastKey = { chunkRow, chunkCol };
+		lastChunk = chunk;
+	}
+	return chunk;
+}
+
+/**
+ * Intent : 用 (seed, 區塊位置) 的隨機數串流產生區塊的炸彈
+ * Pre : 區塊剛配置
+ * Post : 炸彈產生完成，炸彈數量同步更新
+ * \param chunk 區塊指標
+ * \param chunkRow 區塊的row位置
+ * \param chunkCol 區塊的col位置
+ */
+void ChunkBoardCore::GenerateChunk(Chunk* chunk, long long chunkRow, long long chunkCol)
+{
+	unsigned char* bytes = reinterpret_cast<unsigned char*>(chunk->cells);
+	int bombCount = 0;
+
+	if (bombRate >= 1.0f)
+	{
+		for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; i++)
+		{
+			bytes[i] |= CellCore::BOMB_MASK;
+		}
+		bombCount = CHUNK_SIZE * CHUNK_SIZE;
+	}
+	else if (bombRate > 0.0f)
+	{
+		//每個區塊使用自己的隨機數串流，產生的順序不影響結果
+		RandomCore random(seed, RandomCore::Mix((std::uint64_t)chunkRow) ^ (std::uint64_t)chunkCol);
+		std::uint64_t threshold = (std::uint64_t)((double)bombRate * 18446744073709551616.0);
+		for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; i++)
+		{
+			if (random.Next() < threshold)
+			{
+				bytes[i] |= CellCore::BOMB_MASK;
+				bombCount++;
+			}
+		}
+	}
+
+	totalBombCount += bombCount;
+}
+
+/**
+ * Intent : 以周遭8個區塊的炸彈計算區塊內每格的near bomb count
+ * Pre : 區塊已產生
+ * Post : 計算完成，探索範圍同步更新
+ * \param chunk 區塊指標
+ * \param chunkRow 區塊的row位置
+ * \param chunkCol 區塊的col位置
+ */
+void ChunkBoardCore::CountChunk(Chunk* chunk, long long chunkRow, long long chunkCol)
+{
+	//把自己與周遭區塊相鄰的一圈格子的炸彈抄到 (CHUNK_SIZE + 2)^2 的buffer中
+	const int paddedSize = CHUNK_SIZE + 2;
+	unsigned char bombs[paddedSize * paddedSize];
+	for (int i = 0; i < paddedSize; i++)
+	{
+		long long row = chunkRow * CHUNK_SIZE + i - 1;
+		for (int j = 0; j < paddedSize; j++)
+		{
+			long long col = chunkCol * CHUNK_SIZE + j - 1;
+			if (!ValidRowCol(row, col))
+			{
+				bombs[i * paddedSize + j] = 0;
+				continue;
+			}
+
+			//內部的格子直接讀自己，避免每格都查表
+			Chunk* source = (i >= 1 && i <= CHUNK_SIZE && j >= 1 && j <= CHUNK_SIZE) ? chunk : GetChunk(row >> CHUNK_SHIFT, col >> CHUNK_SHIFT);
+			bombs[i * paddedSize + j] = source->cells[(row & (CHUNK_SIZE - 1)) * CHUNK_SIZE + (col & (CHUNK_SIZE - 1))].IsBomb() ? 1 : 0;
+		}
+	}
+
+	//先做水平3格加總，再做垂直3格加總，扣掉自己
+	unsigned char rowSums[paddedSize * CHUNK_SIZE];
+	for (int i = 0; i < paddedSize; i++)
+	{
+		const unsigned char* source = &bombs[i * paddedSize];
+		for (int j = 0; j < CHUNK_SIZE; j++)
+		{
+			rowSums[i * CHUNK_SIZE + j] = source[j] + source[j + 1] + source[j + 2];
+		}
+	}
+
+	for (int i = 0; i < CHUNK_SIZE; i++)
+	{
+		for (int j = 0; j < CHUNK_SIZE; j++)
+		{
+			int count = rowSums[i * CHUNK_SIZE + j] + rowSums[(i + 1) * CHUNK_SIZE + j] + rowSums[(i + 2) * CHUNK_SIZE + j]
+				- bombs[(i + 1) * paddedSize + j + 1];
+			chunk->cells[i * CHUNK_SIZE + j].SetNearBombCount(count);
+		}
+	}
+
+	chunk->countReady = true;
+
+	//更新探索範圍
+	if (maxChunkRow < minChunkRow)
+	{
+		minChunkRow = maxChunkRow = chunkRow;
+		minChunkCol = maxChunkCol = chunkCol;
+	}
+	else
+	{
+		minChunkRow = min(minChunkRow, chunkRow);
+		maxChunkRow = max(maxChunkRow, chunkRow);
+		minChunkCol = min(minChunkCol, chunkCol);
+		maxChunkCol = max(maxChunkCol, chunkCol);
+	}
+}
+
+/**
+ * Intent : 將該格設為開啟狀態，並同步更新已開啟/剩餘的空白格子數量
+ * Pre : 該格可以被開啟且不是炸彈
+ * Post : 該格為開啟狀態
+ * \param cell 格子指標
+ * \param row row位置
+ * \param col col位置
+ */
+void ChunkBoardCore::OpenCell(CellCore* cell, long long row, long long col)
+{
+	cell->SetState(CellState::OPENED);
+	openBlankCount++;
+
+	if (changeLog != nullptr)
+	{
+		changeLog->push_back({ row, col });
+	}
+}
+
+/**
+ * Intent : 設定記錄格子變更的位置，之後FloodOpen與RightClickCell改變的格子都會附加到該vector
+ * Pre :
+ * Post : 設定完成
+ * \param log 記錄的vector (nullptr代表不記錄)
+ */
+void ChunkBoardCore::SetChangeLog(std::vector<CellChange>* log)
+{
+	changeLog = log;
+}
@@ -0,0 +1,383 @@
+﻿/*****************************************************************//**
+ * File : ChunkBoardCore.h
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api header of MineSweeperExample
+ *********************************************************************/
+
+#pragma once
+#ifndef _CHUNKBOARDCORE_H_
+#define _CHUNKBOARDCORE_H_
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "CellCore.h"
+#include "RandomCore.h"
+
+//沒有邊界的盤面，以64x64的區塊 (chunk) 為單位，第一次被存取時才配置並產生炸彈
+//每個區塊的炸彈只由 (seed, 區塊位置) 決定，與存取順序無關，記憶體用量與探索過的範圍成正比
+//row col為64bit，可以是負數
+class ChunkBoardCore
+{
+public:
+
+	//ChunkBoardCore constructor
+	ChunkBoardCore();
+
+	//ChunkBoardCore destructor
+	~ChunkBoardCore();
+
+	/**
+	 * Intent : 載入沒有邊界的盤面 (不配置任何區塊)
+	 * Pre :
+	 * Post : 載入完成
+	 * \param _bombRate 每格的炸彈生成機率
+	 * \param _seed 隨機種子
+	 */
+	void Load(float, std::uint64_t);
+
+	/**
+	 * Intent :	清除已有資訊，區塊記憶體保留給下一次載入重複使用
+	 * Pre :
+	 * Post : 未載入狀態
+	 */
+	void Clear();
+
+	/**
+	 * Intent : 釋放保留的區塊記憶體
+	 * Pre : 未載入 (Clear之後)
+	 * Post : 保留的記憶體超過maxBytes時全部釋放
+	 * \param maxBytes 可以保留的記憶體上限 (byte)
+	 */
+	void ShrinkMem(size_t);
+
+	/**
+	 * Intent : 回傳區塊、hash表與flood fill佇列保留的記憶體大小 (含未使用的容量)
+	 * Pre :
+	 * Post :
+	 * \return 保留的byte數
+	 */
+	size_t GetRetainedMemorySize() const;
+
+	/**
+	 * Intent : 是否已載入過盤面
+	 * Pre :
+	 * Post :
+	 * \return 是否已載入過盤面
+	 */
+	bool IsLoaded();
+
+	/**
+	 * Intent : 印出盤面的一個範圍，範圍內的區塊會被產生
+	 * Pre :
+	 * Post :
+	 * \param output 輸出的緩衝區
+	 * \param top 範圍的第一個row
+	 * \param left 範圍的第一個col
+	 * \param rowCount 範圍的row數量
+	 * \param colCount 範圍的col數量
+	 * \param rowSplit row與row之間的分隔字串
+	 * \param colSplit col與col之間的分隔字串
+	 */
+	void Print(OutputSinkCore&, long long, long long, long long, long long, std::string rowSplit = "\n", std::string colSplit = " ");
+
+	/**
+	 * Intent : 印出盤面一個範圍的解答 (含炸彈位置與每格數字)，範圍內的區塊會被產生
+	 * Pre :
+	 * Post :
+	 * \param output 輸出的緩衝區
+	 * \param top 範圍的第一個row
+	 * \param left 範圍的第一個col
+	 * \param rowCount 範圍的row數量
+	 * \param colCount 範圍的col數量
+	 * \param rowSplit row與row之間的分隔字串
+	 * \param colSplit col與col之間的分隔字串
+	 */
+	void PrintAnswer(OutputSinkCore&, long long, long long, long long, long long, std::string rowSplit = "\n", std::string colSplit = " ");
+
+	/**
+	 * Intent : 回傳已計算好數字的區塊所涵蓋的範圍 (探索過的範圍)
+	 * Pre :
+	 * Post :
+	 * \param top 輸出範圍的第一個row
+	 * \param left 輸出範圍的第一個col
+	 * \param rowCount 輸出範圍的row數量
+	 * \param colCount 輸出範圍的col數量
+	 * \return 是否有探索過的範圍
+	 */
+	bool GetExploredRange(long long&, long long&, long long&, long long&);
+
+	/**
+	 * Intent : 獲取該格的指標，該格所在的區塊與周遭的區塊會被產生，數字已計算完成
+	 * Pre :
+	 * Post :
+	 * \param row row的位置
+	 * \param col col的位置
+	 * \return 該格的指標，超出範圍時為nullptr
+	 */
+	CellCore* GetCell(long long, long long);
+
+	/**
+	 * Intent : 計算該格周遭九宮格內的炸彈數量 (near bomb count)
+	 * Pre :
+	 * Post :
+	 * \param row row位置
+	 * \param col col位置
+	 * \return 該格周遭九宮格內的炸彈數量
+	 */
+	int GetNearBombCount(long long, long long);
+
+	/**
+	 * Intent : 從指定格子開始開啟整個區域 (flood fill)，一次最多開啟FLOOD_MAX_CELLS格
+	 * Pre : 該格不是炸彈
+	 * Post : 該區域內可開啟的格子都被開啟 (超過上限時，剩下的格子保持關閉)
+	 * \param row row位置
+	 * \param col col位置
+	 */
+	void FloodOpen(long long, long long);
+
+	/**
+	 * Intent : 對該格執行RightClick標註，並同步更新旗幟數量
+	 * Pre :
+	 * Post : 標註完成
+	 * \param row row位置
+	 * \param col col位置
+	 */
+	void RightClickCell(long long, long long);
+
+	/**
+	 * Intent : 設定記錄格子變更的位置，之後FloodOpen與RightClickCell改變的格子都會附加到該vector
+	 * Pre :
+	 * Post : 設定完成
+	 * \param log 記錄的vector (nullptr代表不記錄)
+	 */
+	void SetChangeLog(std::vector<CellChange>*);
+
+	/**
+	 * Intent : 移除點擊位置周遭九宮格內的炸彈，讓第一次點擊必定安全並開出0
+	 *          沒有邊界的盤面沒有固定的炸彈數量，所以不需要搬到別的地方
+	 * Pre : 尚未開啟任何格子
+	 * Post : 炸彈移除完成，周遭的near bomb count同步更新
+	 * \param row 點擊的row位置
+	 * \param col 點擊的col位置
+	 */
+	void ClearBombsAround(long long, long long);
+
+	/**
+	 * Intent : 把所有已計算好數字的區塊都開啟，遊戲結束顯示解答時使用
+	 * Pre :
+	 * Post : 探索過的格子都被開啟
+	 */
+	void UncoverAll();
+
+	/**
+	 * Intent :	輸入的row col是否合法 (在座標上限內)
+	 * Pre :
+	 * Post :
+	 * \param row 輸入的row
+	 * \param col 輸入的col
+	 * \return 輸入的row col是否合法
+	 */
+	bool ValidRowCol(long long, long long);
+
+	/**
+	 * Intent : 回傳已產生的區塊中的炸彈數量
+	 * Pre :
+	 * Post :
+	 * \return 已產生的區塊中的炸彈數量
+	 */
+	long long GetTotalBombCount();
+
+	/**
+	 * Intent : 回傳旗幟總數量
+	 * Pre :
+	 * Post :
+	 * \return 回傳旗幟總數量
+	 */
+	long long GetTotalFlagCount();
+
+	/**
+	 * Intent :	回傳已開啟的空白格子數量
+	 * Pre :
+	 * Post :
+	 * \return 已開啟的空白格子數量
+	 */
+	long long GetOpenBlankCount();
+
+	/**
+	 * Intent :	回傳已產生的區塊中，剩餘未開啟的空白格子數量
+	 * Pre :
+	 * Post :
+	 * \return 已產生的區塊中剩餘未開啟的空白格子數量
+	 */
+	long long GetRemainBlankCount();
+
+	/**
+	 * Intent : 回傳已配置的區塊數量
+	 * Pre :
+	 * Post :
+	 * \return 已配置的區塊數量
+	 */
+	long long GetChunkCount();
+
+	//區塊的邊長 (2的次方)
+	static const int CHUNK_SHIFT = 6;
+	static const int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+
+	//row col的絕對值上限，周遭格子與區塊位置的計算都不會溢位
+	static const long long COORD_LIMIT = 1LL << 62;
+
+	//一次flood fill最多開啟的格子數 (剛好停在上限)，炸彈機率很低時0區域可能沒有盡頭
+	static const long long FLOOD_MAX_CELLS = 1LL << 22;
+
+	//一次Print最多印出的格子數，範圍超過時不印出，避免一個指令產生大量區塊與輸出
+	static const long long PRINT_MAX_CELLS = 1LL << 24;
+
+private:
+
+	//區塊的位置 (row col各除以CHUNK_SIZE並向下取整)
+	struct ChunkKey
+	{
+		long long row;
+		long long col;
+
+		bool operator==(const ChunkKey& other) const
+		{
+			return row == other.row && col == other.col;
+		}
+	};
+
+	//區塊位置的hash
+	struct ChunkKeyHash
+	{
+		size_t operator()(const ChunkKey& key) const
+		{
+			return (size_t)RandomCore::Mix((std::uint64_t)key.row * 0x9E3779B97F4A7C15ULL ^ (std::uint64_t)key.col);
+		}
+	};
+
+	//一個區塊的格子 (row-major)，countReady代表near bomb count是否已計算
+	//計算數字需要周遭8個區塊的炸彈，所以周遭的區塊只會產生炸彈，等到被存取時才計算數字
+	struct Chunk
+	{
+		CellCore cells[CHUNK_SIZE * CHUNK_SIZE];
+		bool countReady = false;
+	};
+
+	//hash表的一格，chunk為nullptr代表空位
+	struct ChunkSlot
+	{
+		ChunkKey key = { 0, 0 };
+		Chunk* chunk = nullptr;
+	};
+
+	/**
+	 * Intent : 取得區塊，不存在時配置並產生炸彈
+	 * Pre :
+	 * Post :
+	 * \param chunkRow 區塊的row位置
+	 * \param chunkCol 區塊的col位置
+	 * \return 區塊的指標
+	 */
+	Chunk* GetChunk(long long, long long);
+
+	/**
+	 * Intent : 取出一個格子為預設值的區塊 (優先重複使用Clear前配置的區塊)
+	 * Pre :
+	 * Post : chunkCount加1
+	 * \return 區塊的指標
+	 */
+	Chunk* AllocateChunk();
+
+	/**
+	 * Intent : 把hash表加大一倍，重新放入所有區塊
+	 * Pre :
+	 * Post :
+	 */
+	void GrowChunkTable();
+
+	/**
+	 * Intent : 取得區塊，並確保near bomb count已計算完成
+	 * Pre :
+	 * Post :
+	 * \param chunkRow 區塊的row位置
+	 * \param chunkCol 區塊的col位置
+	 * \return 區塊的指標
+	 */
+	Chunk* GetCountedChunk(long long, long long);
+
+	/**
+	 * Intent : 用 (seed, 區塊位置) 的隨機數串流產生區塊的炸彈
+	 * Pre : 區塊剛配置
+	 * Post : 炸彈產生完成，炸彈數量同步更新
+	 * \param chunk 區塊指標
+	 * \param chunkRow 區塊的row位置
+	 * \param chunkCol 區塊的col位置
+	 */
+	void GenerateChunk(Chunk*, long long, long long);
+
+	/**
+	 * Intent : 以周遭8個區塊的炸彈計算區塊內每格的near bomb count
+	 * Pre : 區塊已產生
+	 * Post : 計算完成，探索範圍同步更新
+	 * \param chunk 區塊指標
+	 * \param chunkRow 區塊的row位置
+	 * \param chunkCol 區塊的col位置
+	 */
+	void CountChunk(Chunk*, long long, long long);
+
+	/**
+	 * Intent : 將該格設為開啟狀態，並同步更新已開啟/剩餘的空白格子數量
+	 * Pre : 該格可以被開啟且不是炸彈
+	 * Post : 該格為開啟狀態
+	 * \param cell 格子指標
+	 * \param row row位置
+	 * \param col col位置
+	 */
+	void OpenCell(CellCore*, long long, long long);
+
+	//所有已配置的區塊，前chunkCount個使用中，Clear後保留給下一局重複使用
+	std::vector<std::unique_ptr<Chunk>> chunkStorage;
+	size_t chunkCount = 0;
+
+	//區塊位置對應到區塊的hash表 (open addressing、線性探測，大小為2的次方)，Clear後保留大小
+	std::vector<ChunkSlot> chunkTable;
+
+	//最近一次存取的區塊，連續存取同一個區塊時不需要查表
+	ChunkKey lastKey = { 0, 0 };
+	Chunk* lastChunk = nullptr;
+
+	//已計算好數字的區塊範圍 (區塊位置，含兩端)
+	long long minChunkRow = 0;
+	long long maxChunkRow = -1;
+	long long minChunkCol = 0;
+	long long maxChunkCol = -1;
+
+	//炸彈生成機率與隨機種子
+	float bombRate = 0.0f;
+	std::uint64_t seed = 0;
+
+	//是否已載入
+	bool loaded = false;
+
+	//格子變更的紀錄 (nullptr代表不記錄)
+	std::vector<CellChange>* changeLog = nullptr;
+
+	//紀錄count的變數，隨區塊產生與格子狀態改變而增量更新
+	long long totalBombCount = 0;
+	long long totalFlagCount = 0;
+	long long openBlankCount = 0;
+
+	//flood fill使用的工作佇列 (格子的row col)，以索引由前往後讀取，重複使用
+	std::vector<std::pair<long long, long long>> floodQueue;
+};
+
+#endif // !_CHUNKBOARDCORE_H_
@@ -0,0 +1,435 @@
+﻿/*****************************************************************//**
+ * File : CommandBatchCore.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api implementation of MineSweeperExample
+ *********************************************************************/
+
+#include "CommandBatchCore.h"
+
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <direct.h>
+#else
+#include <dirent.h>
+#endif
+
+using namespace std;
+
+//指令檔名稱的前綴，以及對應輸出檔名稱的前綴
+static const string COMMAND_PREFIX = "command";
+static const string OUTPUT_PREFIX = "output";
+
+/**
+ * Intent : 執行批次模式，並把比對結果與throughput印到report
+ * Pre :
+ * Post : 輸出檔寫入outputDir
+ * \param input 指令檔所在的資料夾，或manifest檔
+ * \param outputDir 輸出資料夾 (不存在時建立)
+ * \param report 印出結果的stream
+ * \return 是否所有指令檔都成功執行，且有預期輸出的都相同
+ */
+bool CommandBatchCore::Run(const std::string& input, const std::string& outputDir, std::ostream& report)
+{
+	vector<BatchFile> files;
+	string error;
+	if (!CollectFiles(input, outputDir, files, error))
+	{
+		report << error << endl;
+		return false;
+	}
+
+	//每個執行緒一次領取一個指令檔，遊戲本身只用一個執行緒，平行度來自同時執行多個檔案
+	vector<BatchResult> results(files.size());
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	ThreadPoolCore::Instance().Run((int)files.size(), [&](int index)
+	{
+		results[index] = RunFile(files[index]);
+	}, ThreadPoolCore::HardwareThreadCount());
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	//依檔案順序列出失敗的檔案
+	long long commandCount = 0;
+	int matchedCount = 0, mismatchedCount = 0, uncheckedCount = 0, failedCount = 0;
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		const BatchResult& result = results[i];
+		commandCount += result.commandCount;
+
+		if (!result.opened)
+		{
+			failedCount++;
+			report << "Failed : " << files[i].commandPath << " (cannot open command or output file)" << endl;
+		}
+		else if (!result.hasExpected)
+		{
+			uncheckedCount++;
+		}
+		else if (result.matched)
+		{
+			matchedCount++;
+		}
+		else
+		{
+			mismatchedCount++;
+			report << "Mismatch : " << files[i].commandPath << " (first difference at byte " << result.mismatchOffset << " of " << files[i].expectedPath << ")" << endl;
+		}
+	}
+
+	double rateSeconds = max(seconds, 1e-9);
+	report << "Files : " << files.size() << ", Commands : " << commandCount << endl;
+	report << "Diff : " << matchedCount << " matched, " << mismatchedCount << " mismatched, " << uncheckedCount << " without expected output, " << failedCount << " failed" << endl;
+	report << fixed << setprecision(3) << "Time : " << seconds << " s" << endl;
+	report << setprecision(1) << "Throughput : " << files.size() / rateSeconds << " files/sec, " << commandCount / rateSeconds << " commands/sec" << endl;
+
+	return mismatchedCount == 0 && failedCount == 0;
+}
+
+/**
+ * Intent : 列出要執行的指令檔，並決定預期輸出檔與輸出檔的路徑
+ * Pre :
+ * Post :
+ * \param input 指令檔所在的資料夾，或manifest檔
+ * \param outputDir 輸出資料夾
+ * \param files 輸出的指令檔清單
+ * \param error 失敗時的原因
+ * \return 是否成功
+ */
+bool CommandBatchCore::CollectFiles(const std::string& input, const std::string& outputDir, std::vector<BatchFile>& files, std::string& error)
+{
+	files.clear();
+
+	if (!MakeDirectory(outputDir))
+	{
+		error = "cannot create output directory " + outputDir;
+		return false;
+	}
+
+	if (IsDirectory(input))
+	{
+		vector<string> names;
+		if (!ListFiles(input, names))
+		{
+			error = "cannot list directory " + input;
+			return false;
+		}
+
+		for (size_t i = 0; i < names.size(); i++)
+		{
+			if (names[i].compare(0, COMMAND_PREFIX.size(), COMMAND_PREFIX) != 0)
+			{
+				continue;
+			}
+
+			BatchFile file;
+			file.commandPath = JoinPath(input, names[i]);
+			file.outputPath = JoinPath(outputDir, OutputName(names[i]));
+			string expectedPath = JoinPath(input, OutputName(names[i]));
+			if (IsFile(expectedPath))
+			{
+				file.expectedPath = expectedPath;
+			}
+			files.push_back(file);
+		}
+	}
+	else
+	{
+		ifstream manifest(input);
+		if (!manifest.is_open())
+		{
+			error = "cannot open " + input;
+			return false;
+		}
+
+		string baseDir = DirName(input);
+		string line;
+		int lineNumber = 0;
+		while (getline(manifest, line))
+		{
+			lineNumber++;
+			istringstream lineStream(line);
+			string commandPath, expectedPath;
+			if (!(lineStream >> commandPath) || commandPath[0] == '#')
+			{
+				continue;
+			}
+			lineStream >> expectedPath;
+
+			BatchFile file;
+			file.commandPath = JoinPath(baseDir, commandPath);
+			file.outputPath = JoinPath(outputDir, OutputName(BaseName(commandPath)));
+			if (!expectedPath.empty())
+			{
+				file.expectedPath = JoinPath(baseDir, expectedPath);
+			}
+			files.push_back(file);
+		}
+	}
+
+	//輸出檔不能互相覆蓋，也不能覆蓋到預期輸出檔
+	vector<string> outputPaths;
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		if (files[i].outputPath == files[i].expectedPath)
+		{
+			error = "output file " + files[i].outputPath + " would overwrite the expected output";
+			return false;
+		}
+		outputPaths.push_back(files[i].outputPath);
+	}
+	sort(outputPaths.begin(), outputPaths.end());
+	vector<string>::iterator duplicate = adjacent_find(outputPaths.begin(), outputPaths.end());
+	if (duplicate != outputPaths.end())
+	{
+		error = "more than one command file writes to " + *duplicate;
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Intent : 用pool中的MineSweeperCore執行一個指令檔，寫出輸出並與預期輸出比對
+ * Pre :
+ * Post : 輸出檔寫入完成
+ * \param file 要執行的指令檔
+ * \return 執行結果
+ */
+CommandBatchCore::BatchResult CommandBatchCore::RunFile(const BatchFile& file)
+{
+	BatchResult result;
+
+	//與CommandFile模式相同，以文字模式寫出與比對
+	ofstream outputFile(file.outputPath);
+	if (!outputFile.is_open())
+	{
+		return result;
+	}
+
+	ifstream expectedFile;
+	if (!file.expectedPath.empty())
+	{
+		expectedFile.open(file.expectedPath);
+	}
+	result.hasExpected = expectedFile.is_open();
+	result.matched = result.hasExpected;
+
+	//每次flush的區塊一邊寫出，一邊與預期輸出的同一段比對，記憶體用量只有一個區塊
+	long long offset = 0;
+	vector<char> expectedChunk;
+	{
+		unique_ptr<MineSweeperCore> game = SessionPoolCore::Instance().Acquire([&](const char* data, size_t size)
+		{
+			outputFile.write(data, size);
+
+			if (result.matched)
+			{
+				expectedChunk.resize(size);
+				expectedFile.read(expectedChunk.data(), size);
+				size_t expectedSize = (size_t)expectedFile.gcount();
+				size_t sameSize = 0;
+				while (sameSize < expectedSize && expectedChunk[sameSize] == data[sameSize])
+				{
+					sameSize++;
+				}
+				if (sameSize < size)
+				{
+					result.matched = false;
+					result.mismatchOffset = offset + (long long)sameSize;
+				}
+			}
+			offset += (long long)size;
+		});
+
+		//Quit只結束這個遊戲，不結束整個程式
+		game->SetExitOnQuit(false);
+		game->SetThreadCount(1);
+		result.opened = game->ExecuteCommandFile(file.commandPath);
+		result.commandCount = game->GetCommandCount();
+
+		//ExecuteCommandFile結束時已寫出所有輸出，遊戲歸還給pool給下一個指令檔使用
+		SessionPoolCore::Instance().Release(move(game));
+	}
+
+	//預期輸出比實際輸出還長
+	if (result.matched && expectedFile.peek() != ifstream::traits_type::eof())
+	{
+		result.matched = false;
+		result.mismatchOffset = offset;
+	}
+
+	return result;
+}
+
+/**
+ * Intent : 路徑是否為資料夾
+ * Pre :
+ * Post :
+ * \param path 路徑
+ * \return 是否為資料夾
+ */
+bool CommandBatchCore::IsDirectory(const std::string& path)
+{
+#ifdef _WIN32
+	struct _stat64 info;
+	return _stat64(path.c_str(), &info) == 0 && (info.st_mode & _S_IFDIR) != 0;
+#else
+	struct stat info;
+	return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+#endif
+}
+
+/**
+ * Intent : 路徑是否為一般檔案
+ * Pre :
+ * Post :
+ * \param path 路徑
+ * \return 是否為一般檔案
+ */
+bool CommandBatchCore::IsFile(const std::string& path)
+{
+#ifdef _WIN32
+	struct _stat64 info;
+	return _stat64(path.c_str(), &info) == 0 && (info.st_mode & _S_IFREG) != 0;
+#else
+	struct stat info;
+	return stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode);
+#endif
+}
+
+/**
+ * Intent : 列出資料夾中的一般檔案名稱 (依名稱排序)
+ * Pre :
+ * Post :
+ * \param dir 資料夾
+ * \param names 輸出的檔案名稱
+ * \return 是否成功
+ */
+bool CommandBatchCore::ListFiles(const std::string& dir, std::vector<std::string>& names)
+{
+	names.clear();
+
+#ifdef _WIN32
+	WIN32_FIND_DATAA entry;
+	HANDLE findHandle = FindFirstFileA(JoinPath(dir, "*").c_str(), &entry);
+	if (findHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	do
+	{
+		if ((entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+		{
+			names.push_back(entry.cFileName);
+		}
+	} while (FindNextFileA(findHandle, &entry));
+	FindClose(findHandle);
+#else
+	DIR* dirHandle = opendir(dir.c_str());
+	if (dirHandle == nullptr)
+	{
+		return false;
+	}
+	struct dirent* entry;
+	while ((entry = readdir(dirHandle)) != nullptr)
+	{
+		if (IsFile(JoinPath(dir, entry->d_name)))
+		{
+			names.push_back(entry->d_name);
+		}
+	}
+	closedir(dirHandle);
+#endif
+
+	sort(names.begin(), names.end());
+	return true;
+}
+
+/**
+ * Intent : 建立資料夾 (已存在時也算成功)
+ * Pre :
+ * Post :
+ * \param dir 資料夾
+ * \return 是否成功
+ */
+bool CommandBatchCore::MakeDirectory(const std::string& dir)
+{
+	if (IsDirectory(dir))
+	{
+		return true;
+	}
+#ifdef _WIN32
+	return _mkdir(dir.c_str()) == 0;
+#else
+	return mkdir(dir.c_str(), 0755) == 0;
+#endif
+}
+
+/**
+ * Intent : 組合資料夾與檔名
+ * Pre :
+ * Post :
+ * \param dir 資料夾 (空字串代表目前資料夾)
+ * \param name 檔名或相對路徑
+ * \return 組合後的路徑
+ */
+std::string CommandBatchCore::JoinPath(const std::string& dir, const std::string& name)
+{
+	//絕對路徑不需要組合
+	bool absolute = !name.empty() && (name[0] == '/' || name[0] == '\\' || (name.size() > 1 && name[1] == ':'));
+	if (dir.empty() || absolute)
+	{
+		return name;
+	}
+	char last = dir[dir.size() - 1];
+	return (last == '/' || last == '\\') ? dir + name : dir + "/" + name;
+}
+
+/**
+ * Intent : 拆出路徑的資料夾部分
+ * Pre :
+ * Post :
+ * \param path 路徑
+ * \return 資料夾 (沒有資料夾時為空字串)
+ */
+std::string CommandBatchCore::DirName(const std::string& path)
+{
+	size_t split = path.find_last_of("/\\");
+	return split == string::npos ? string() : path.substr(0, split + 1);
+}
+
+/**
+ * Intent : 拆出路徑的檔名部分
+ * Pre :
+ * Post :
+ * \param path 路徑
+ * \return 檔名
+ */
+std::string CommandBatchCore::BaseName(const std::string& path)
+{
+	size_t split = path.find_last_of("/\\");
+	return split == string::npos ? path : path.substr(split + 1);
+}
+
+/**
+ * Intent : 指令檔對應的輸出檔名 (開頭的command換成output，否則加上.out)
+ * Pre :
+ * Post :
+ * \param commandName 指令檔名
+ * \return 輸出檔名
+ */
+std::string CommandBatchCore::OutputName(const std::string& commandName)
+{
+	if (commandName.compare(0, COMMAND_PREFIX.size(), COMMAND_PREFIX) == 0)
+	{
+		return OUTPUT_PREFIX + commandName.substr(COMMAND_PREFIX.size());
+	}
+	return commandName + ".out";
+}
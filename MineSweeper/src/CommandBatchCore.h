@@ -0,0 +1,162 @@
+﻿/*****************************************************************//**
+ * File : CommandBatchCore.h
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api header of MineSweeperExample
+ *********************************************************************/
+
+#pragma once
+#ifndef _COMMANDBATCHCORE_H_
+#define _COMMANDBATCHCORE_H_
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "MineSweeperCore.h"
+#include "SessionPoolCore.h"
+#include "ThreadPoolCore.h"
+
+//批次執行大量指令檔 : 每個指令檔由從SessionPoolCore取得的MineSweeperCore執行，由thread pool的執行緒動態領取下一個檔案
+//有預期輸出檔時，在寫出輸出的同時逐塊比對，不需要把整個檔案讀進記憶體
+//輸入可以是資料夾 (所有command開頭的檔案，預期輸出為同資料夾中把command換成output的檔案)
+//或是manifest檔 (每行為 "指令檔 [預期輸出檔]"，相對路徑以manifest所在的資料夾為準，#開頭為註解)
+class CommandBatchCore
+{
+public:
+
+	//一個要執行的指令檔
+	struct BatchFile
+	{
+		std::string commandPath;
+		std::string expectedPath;
+		std::string outputPath;
+	};
+
+	//一個指令檔的執行結果
+	struct BatchResult
+	{
+		bool opened = false;
+		bool hasExpected = false;
+		bool matched = false;
+		long long mismatchOffset = -1;
+		long long commandCount = 0;
+	};
+
+	/**
+	 * Intent : 執行批次模式，並把比對結果與throughput印到report
+	 * Pre :
+	 * Post : 輸出檔寫入outputDir
+	 * \param input 指令檔所在的資料夾，或manifest檔
+	 * \param outputDir 輸出資料夾 (不存在時建立)
+	 * \param report 印出結果的stream
+	 * \return 是否所有指令檔都成功執行，且有預期輸出的都相同
+	 */
+	static bool Run(const std::string&, const std::string&, std::ostream&);
+
+	/**
+	 * Intent : 列出要執行的指令檔，並決定預期輸出檔與輸出檔的路徑
+	 * Pre :
+	 * Post :
+	 * \param input 指令檔所在的資料夾，或manifest檔
+	 * \param outputDir 輸出資料夾
+	 * \param files 輸出的指令檔清單
+	 * \param error 失敗時的原因
+	 * \return 是否成功
+	 */
+	static bool CollectFiles(const std::string&, const std::string&, std::vector<BatchFile>&, std::string&);
+
+	/**
+	 * Intent : 用pool中的MineSweeperCore執行一個指令檔，寫出輸出並與預期輸出比對
+	 * Pre :
+	 * Post : 輸出檔寫入完成
+	 * \param file 要執行的指令檔
+	 * \return 執行結果
+	 */
+	static BatchResult RunFile(const BatchFile&);
+
+private:
+
+	/**
+	 * Intent : 路徑是否為資料夾
+	 * Pre :
+	 * Post :
+	 * \param path 路徑
+	 * \return 是否為資料夾
+	 */
+	static bool IsDirectory(const std::string&);
+
+	/**
+	 * Intent : 路徑是否為一般檔案
+	 * Pre :
+	 * Post :
+	 * \param path 路徑
+	 * \return 是否為一般檔案
+	 */
+	static bool IsFile(const std::string&);
+
+	/**
+	 * Intent : 列出資料夾中的一般檔案名稱 (依名稱排序)
+	 * Pre :
+	 * Post :
+	 * \param dir 資料夾
+	 * \param names 輸出的檔案名稱
+	 * \return 是否成功
+	 */
+	static bool ListFiles(const std::string&, std::vector<std::string>&);
+
+	/**
+	 * Intent : 建立資料夾 (已存在時也算成功)
+	 * Pre :
+	 * Post :
+	 * \param dir 資料夾
+	 * \return 是否成功
+	 */
+	static bool MakeDirectory(const std::string&);
+
+	/**
+	 * Intent : 組合資料夾與檔名
+	 * Pre :
+	 * Post :
+	 * \param dir 資料夾 (空字串代表目前資料夾)
+	 * \param name 檔名或相對路徑
+	 * \return 組合後的路徑
+	 */
+	static std::string JoinPath(const std::string&, const std::string&);
+
+	/**
+	 * Intent : 拆出路徑的資料夾部分
+	 * Pre :
+	 * Post :
+	 * \param path 路徑
+	 * \return 資料夾 (沒有資料夾時為空字串)
+	 */
+	static std::string DirName(const std::string&);
+
+	/**
+	 * Intent : 拆出路徑的檔名部分
+	 * Pre :
+	 * Post :
+	 * \param path 路徑
+	 * \return 檔名
+	 */
+	static std::string BaseName(const std::string&);
+
+	/**
+	 * Intent : 指令檔對應的輸出檔名 (開頭的command換成output，否則加上.out)
+	 * Pre :
+	 * Post :
+	 * \param commandName 指令檔名
+	 * \return 輸出檔名
+	 */
+	static std::string OutputName(const std::string&);
+};
+
+#endif // !_COMMANDBATCHCORE_H_
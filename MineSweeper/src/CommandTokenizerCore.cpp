@@ -0,0 +1,227 @@
+﻿/*****************************************************************//**
+ * File : CommandTokenizerCore.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api implementation of MineSweeperExample
+ *********************************************************************/
+
+#include "CommandTokenizerCore.h"
+
+#include <climits>
+#include <clocale>
+#include <cmath>
+#include <cstdlib>
+
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+
+using namespace std;
+
+//float token最長的長度，超過時一定不是合法的數字
+static const size_t FLOAT_TOKEN_MAX = 63;
+
+/**
+ * Intent : 以"C" locale把字串解析成float (小數點固定是'.')
+ *          strtof依照目前的locale，QApplication會把locale設成系統設定，小數點為','的系統上會解析失敗
+ * Pre : text以0結尾
+ * Post :
+ * \param text 要解析的字串
+ * \param parsedEnd 輸出解析結束的位置
+ * \return 解析的數值
+ */
+static float ParseClassicFloat(const char* text, char** parsedEnd)
+{
+#ifdef _WIN32
+	static const _locale_t classicLocale = _create_locale(LC_NUMERIC, "C");
+	return _strtof_l(text, parsedEnd, classicLocale);
+#else
+	static const locale_t classicLocale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+	return strtof_l(text, parsedEnd, classicLocale);
+#endif
+}
+
+/**
+ * Intent : 是否為空白字元 (與stream的>>相同)
+ * Pre :
+ * Post :
+ * \param value 字元
+ * \return 是否為空白字元
+ */
+static bool IsSpace(char value)
+{
+	return value == ' ' || (value >= '\t' && value <= '\r');
+}
+
+//CommandTokenizerCore constructor
+CommandTokenizerCore::CommandTokenizerCore(const char* data, size_t size) : position(data), end(data + size)
+{
+
+}
+
+/**
+ * Intent : 讀取下一個token
+ * Pre :
+ * Post : 成功時token指向下一個token
+ * \param token 輸出的token
+ * \return 是否還有token
+ */
+bool CommandTokenizerCore::Next(CommandToken& token)
+{
+	while (position < end && IsSpace(*position))
+	{
+		position++;
+	}
+	if (position == end)
+	{
+		return false;
+	}
+
+	const char* begin = position;
+	while (position < end && !IsSpace(*position))
+	{
+		position++;
+	}
+	token.data = begin;
+	token.size = position - begin;
+	return true;
+}
+
+/**
+ * Intent : 讀取下一個token並解析成int
+ * Pre :
+ * Post : 不論成功與否都會消耗一個token
+ * \param value 輸出的數值
+ * \return 是否成功 (沒有token、不是整數或超出範圍時失敗)
+ */
+bool CommandTokenizerCore::NextInt(int& value)
+{
+	long long wide;
+	if (!NextLongLong(wide) || wide < INT_MIN || wide > INT_MAX)
+	{
+		return false;
+	}
+	value = (int)wide;
+	return true;
+}
+
+/**
+ * Intent : 讀取下一個token並解析成long long
+ * Pre :
+ * Post : 不論成功與否都會消耗一個token
+ * \param value 輸出的數值
+ * \return 是否成功 (沒有token、不是整數或超出範圍時失敗)
+ */
+bool CommandTokenizerCore::NextLongLong(long long& value)
+{
+	CommandToken token;
+	std::uint64_t magnitude;
+	bool negative;
+	if (!Next(token) || !ParseInteger(token, magnitude, negative))
+	{
+		return false;
+	}
+
+	if (negative)
+	{
+		if (magnitude > (std::uint64_t)LLONG_MAX + 1)
+		{
+			return false;
+		}
+		value = (long long)(0 - magnitude);
+	}
+	else
+	{
+		if (magnitude > (std::uint64_t)LLONG_MAX)
+		{
+			return false;
+		}
+		value = (long long)magnitude;
+	}
+	return true;
+}
+
+/**
+ * Intent : 讀取下一個token並解析成無號64bit整數
+ * Pre :
+ * Post : 不論成功與否都會消耗一個token
+ * \param value 輸出的數值
+ * \return 是否成功 (沒有token、不是整數或超出範圍時失敗)
+ */
+bool CommandTokenizerCore::NextUInt64(std::uint64_t& value)
+{
+	CommandToken token;
+	bool negative;
+	if (!Next(token) || !ParseInteger(token, value, negative) || negative)
+	{
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Intent : 讀取下一個token並解析成float
+ * Pre :
+ * Post : 不論成功與否都會消耗一個token
+ * \param value 輸出的數值
+ * \return 是否成功 (沒有token、不是數字或不是有限的數字時失敗)
+ */
+bool CommandTokenizerCore::NextFloat(float& value)
+{
+	CommandToken token;
+	if (!Next(token) || token.size > FLOAT_TOKEN_MAX)
+	{
+		return false;
+	}
+
+	//strtof需要以0結尾的字串，複製到stack上的buffer
+	char buffer[FLOAT_TOKEN_MAX + 1];
+	memcpy(buffer, token.data, token.size);
+	buffer[token.size] = '\0';
+
+	//與stream的>>相同，不受目前locale影響
+	char* parsedEnd = nullptr;
+	value = ParseClassicFloat(buffer, &parsedEnd);
+	return parsedEnd == buffer + token.size && std::isfinite(value);
+}
+
+/**
+ * Intent : 把整數token解析成絕對值與正負號
+ * Pre :
+ * Post :
+ * \param token 要解析的token
+ * \param magnitude 輸出的絕對值
+ * \param negative 輸出是否為負數
+ * \return 是否成功 (不是整數或絕對值超過64bit時失敗)
+ */
+bool CommandTokenizerCore::ParseInteger(const CommandToken& token, std::uint64_t& magnitude, bool& negative)
+{
+	const char* cursor = token.data;
+	const char* tokenEnd = token.data + token.size;
+
+	negative = false;
+	if (cursor < tokenEnd && (*cursor == '+' || *cursor == '-'))
+	{
+		negative = *cursor == '-';
+		cursor++;
+	}
+	if (cursor == tokenEnd)
+	{
+		return false;
+	}
+
+	//整個token都必須是數字，不接受stream的>>那樣只讀開頭的數字
+	magnitude = 0;
+	for (; cursor < tokenEnd; cursor++)
+	{
+		unsigned digit = (unsigned)(*cursor - '0');
+		if (digit > 9 || magnitude > (UINT64_MAX - digit) / 10)
+		{
+			return false;
+		}
+		magnitude = magnitude * 10 + digit;
+	}
+	return true;
+}
@@ -0,0 +1,124 @@
+﻿/*****************************************************************//**
+ * File : CommandTokenizerCore.h
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api header of MineSweeperExample
+ *********************************************************************/
+
+#pragma once
+#ifndef _COMMANDTOKENIZERCORE_H_
+#define _COMMANDTOKENIZERCORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+//指令中的一個token，只指向原本的指令字串，不另外配置記憶體
+struct CommandToken
+{
+	const char* data = nullptr;
+	size_t size = 0;
+
+	/**
+	 * Intent : token是否與字串相同
+	 * Pre :
+	 * Post :
+	 * \param text 要比較的字串
+	 * \return 是否相同
+	 */
+	template <size_t N>
+	bool Equals(const char(&text)[N]) const
+	{
+		return size == N - 1 && memcmp(data, text, N - 1) == 0;
+	}
+
+	/**
+	 * Intent : 複製成std::string (檔名等需要保存的參數使用)
+	 * Pre :
+	 * Post :
+	 * \return token的字串
+	 */
+	std::string ToString() const
+	{
+		return std::string(data, size);
+	}
+};
+
+//以空白 (與stream相同的空白字元) 分割指令字串，數字參數直接由token解析，整個過程不配置記憶體
+//數字參數必須是完整的token，這是與舊版stringstream的>>刻意不同的地方 :
+//舊版只讀token開頭的數字 ("2x"讀成2)，之後的參數讀取失敗時變成0或保留未初始化的值，
+//所以"LeftClick 2x 3"會點擊(2, 0)並印出Success，現在這類指令一律Failed
+class CommandTokenizerCore
+{
+public:
+
+	//CommandTokenizerCore constructor
+	CommandTokenizerCore(const char*, size_t);
+
+	/**
+	 * Intent : 讀取下一個token
+	 * Pre :
+	 * Post : 成功時token指向下一個token
+	 * \param token 輸出的token
+	 * \return 是否還有token
+	 */
+	bool Next(CommandToken&);
+
+	/**
+	 * Intent : 讀取下一個token並解析成int
+	 * Pre :
+	 * Post : 不論成功與否都會消耗一個token
+	 * \param value 輸出的數值
+	 * \return 是否成功 (沒有token、不是整數或超出範圍時失敗)
+	 */
+	bool NextInt(int&);
+
+	/**
+	 * Intent : 讀取下一個token並解析成long long
+	 * Pre :
+	 * Post : 不論成功與否都會消耗一個token
+	 * \param value 輸出的數值
+	 * \return 是否成功 (沒有token、不是整數或超出範圍時失敗)
+	 */
+	bool NextLongLong(long long&);
+
+	/**
+	 * Intent : 讀取下一個token並解析成無號64bit整數
+	 * Pre :
+	 * Post : 不論成功與否都會消耗一個token
+	 * \param value 輸出的數值
+	 * \return 是否成功 (沒有token、不是整數或超出範圍時失敗)
+	 */
+	bool NextUInt64(std::uint64_t&);
+
+	/**
+	 * Intent : 讀取下一個token並解析成float
+	 * Pre :
+	 * Post : 不論成功與否都會消耗一個token
+	 * \param value 輸出的數值
+	 * \return 是否成功 (沒有token、不是數字或不是有限的數字時失敗)
+	 */
+	bool NextFloat(float&);
+
+private:
+
+	/**
+	 * Intent : 把整數token解析成絕對值與正負號
+	 * Pre :
+	 * Post :
+	 * \param token 要解析的token
+	 * \param magnitude 輸出的絕對值
+	 * \param negative 輸出是否為負數
+	 * \return 是否成功 (不是整數或絕對值超過64bit時失敗)
+	 */
+	static bool ParseInteger(const CommandToken&, std::uint64_t&, bool&);
+
+	//目前的位置與指令字串結尾
+	const char* position;
+	const char* end;
+};
+
+#endif // !_COMMANDTOKENIZERCORE_H_
@@ -0,0 +1,194 @@
+﻿/*****************************************************************//**
+ * File : MappedFileCore.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api implementation of MineSweeperExample
+ *********************************************************************/
+
+#include "MappedFileCore.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+//MappedFileCore constructor
+MappedFileCore::MappedFileCore()
+{
+
+}
+
+//MappedFileCore destructor
+MappedFileCore::~MappedFileCore()
+{
+	Close();
+}
+
+/**
+ * Intent : 以唯讀方式映射整個檔案
+ * Pre :
+ * Post : 成功時可以用GetData存取檔案內容，原本映射的檔案會先被關閉
+ * \param filename 檔案名稱
+ * \return 是否成功 (空檔案也算成功，GetData為nullptr)
+ */
+bool MappedFileCore::Open(std::string filename)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	fileHandle = file;
+	size = (size_t)fileSize.QuadPart;
+	opened = true;
+
+	//空檔案不能建立映射物件
+	if (size == 0)
+	{
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		Close();
+		return false;
+	}
+	mappingHandle = mapping;
+
+	data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (data == nullptr)
+	{
+		Close();
+		return false;
+	}
+#else
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	size = (size_t)fileStat.st_size;
+	opened = true;
+
+	//空檔案不能映射
+	if (size == 0)
+	{
+		close(fd);
+		return true;
+	}
+
+	//映射建立後就不再需要file descriptor
+	void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapped == MAP_FAILED)
+	{
+		size = 0;
+		opened = false;
+		return false;
+	}
+	data = static_cast<const unsigned char*>(mapped);
+
+	//整個檔案都會被依序讀過一次
+	madvise(mapped, size, MADV_SEQUENTIAL);
+#endif
+
+	return true;
+}
+
+/**
+ * Intent : 解除映射並關閉檔案
+ * Pre :
+ * Post :
+ */
+void MappedFileCore::Close()
+{
+#ifdef _WIN32
+	if (data != nullptr)
+	{
+		UnmapViewOfFile(data);
+	}
+	if (mappingHandle != nullptr)
+	{
+		CloseHandle(mappingHandle);
+		mappingHandle = nullptr;
+	}
+	if (fileHandle != nullptr)
+	{
+		CloseHandle(fileHandle);
+		fileHandle = nullptr;
+	}
+#else
+	if (data != nullptr)
+	{
+		munmap(const_cast<unsigned char*>(data), size);
+	}
+#endif
+
+	data = nullptr;
+	size = 0;
+	opened = false;
+}
+
+/**
+ * Intent : 是否已映射檔案
+ * Pre :
+ * Post :
+ * \return 是否已映射檔案
+ */
+bool MappedFileCore::IsOpen()
+{
+	return opened;
+}
+
+/**
+ * Intent : 回傳檔案內容的起始位置 (頁面對齊)
+ * Pre : 已映射檔案
+ * Post :
+ * \return 檔案內容的起始位置
+ */
+const unsigned char* MappedFileCore::GetData()
+{
+	return data;
+}
+
+/**
+ * Intent : 回傳檔案大小
+ * Pre : 已映射檔案
+ * Post :
+ * \return 檔案大小 (byte)
+ */
+size_t MappedFileCore::GetSize()
+{
+	return size;
+}
@@ -0,0 +1,89 @@
+﻿/*****************************************************************//**
+ * File : MappedFileCore.h
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api header of MineSweeperExample
+ *********************************************************************/
+
+#pragma once
+#ifndef _MAPPEDFILECORE_H_
+#define _MAPPEDFILECORE_H_
+
+#include <cstddef>
+#include <string>
+
+//唯讀的記憶體映射檔案 (Windows用CreateFileMapping，其他平台用mmap)
+//檔案內容由作業系統依需要分頁載入，不需要先整個讀進buffer
+class MappedFileCore
+{
+public:
+
+	//MappedFileCore constructor
+	MappedFileCore();
+
+	//MappedFileCore destructor
+	~MappedFileCore();
+
+	//禁止複製，避免同一個映射被解除兩次
+	MappedFileCore(const MappedFileCore&) = delete;
+	MappedFileCore& operator=(const MappedFileCore&) = delete;
+
+	/**
+	 * Intent : 以唯讀方式映射整個檔案
+	 * Pre :
+	 * Post : 成功時可以用GetData存取檔案內容，原本映射的檔案會先被關閉
+	 * \param filename 檔案名稱
+	 * \return 是否成功 (空檔案也算成功，GetData為nullptr)
+	 */
+	bool Open(std::string);
+
+	/**
+	 * Intent : 解除映射並關閉檔案
+	 * Pre :
+	 * Post :
+	 */
+	void Close();
+
+	/**
+	 * Intent : 是否已映射檔案
+	 * Pre :
+	 * Post :
+	 * \return 是否已映射檔案
+	 */
+	bool IsOpen();
+
+	/**
+	 * Intent : 回傳檔案內容的起始位置 (頁面對齊)
+	 * Pre : 已映射檔案
+	 * Post :
+	 * \return 檔案內容的起始位置
+	 */
+	const unsigned char* GetData();
+
+	/**
+	 * Intent : 回傳檔案大小
+	 * Pre : 已映射檔案
+	 * Post :
+	 * \return 檔案大小 (byte)
+	 */
+	size_t GetSize();
+
+private:
+
+	//映射的起始位置與大小
+	const unsigned char* data = nullptr;
+	size_t size = 0;
+
+	//是否已映射檔案
+	bool opened = false;
+
+#ifdef _WIN32
+	//Windows的檔案與映射物件handle
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#endif
+};
+
+#endif // !_MAPPEDFILECORE_H_
@@ -11,17 +11,154 @@
 
 using namespace std;
 
-//MineSweeperCore constructor
-MineSweeperCore::MineSweeperCore()
+//串流讀取指令檔時每次讀入的區塊大小
+static const size_t COMMAND_CHUNK_SIZE = 1 << 16;
+
+//MineSweeperCore constructor，輸出到std::cout
+MineSweeperCore::MineSweeperCore() : output(cout), payloadSink([this](const char* data, size_t size) { payloadBuffer.insert(payloadBuffer.end(), data, data + size); })
+{
+	gameBoard = new BoardCore();
+	chunkBoard = new ChunkBoardCore();
+}
+
+//MineSweeperCore constructor，輸出到指定的stream
+MineSweeperCore::MineSweeperCore(std::ostream& outputStream) : output(outputStream), payloadSink([this](const char* data, size_t size) { payloadBuffer.insert(payloadBuffer.end(), data, data + size); })
 {
 	gameBoard = new BoardCore();
+	chunkBoard = new ChunkBoardCore();
+}
+
+//MineSweeperCore constructor，輸出交給callback
+MineSweeperCore::MineSweeperCore(OutputSinkCore::Writer outputWriter) : output(outputWriter), payloadSink([this](const char* data, size_t size) { payloadBuffer.insert(payloadBuffer.end(), data, data + size); })
+{
+	gameBoard = new BoardCore();
+	chunkBoard = new ChunkBoardCore();
 }
 
 //MineSweeperCore destructor
 MineSweeperCore::~MineSweeperCore()
 {
-	gameBoard->~BoardCore();
+	delete gameBoard;
 	gameBoard = nullptr;
+	delete chunkBoard;
+	chunkBoard = nullptr;
+}
+
+//指令的種類
+enum class CommandAction
+{
+	LOAD,
+	START_GAME,
+	PRINT,
+	LEFT_CLICK,
+	RIGHT_CLICK,
+	REPLAY,
+	SAVE,
+	SET,
+	QUIT,
+	UNKNOWN,
+};
+
+/**
+ * Intent : 由指令的第一個token判斷指令種類，先依長度分類，同長度的指令再比較內容
+ * Pre :
+ * Post :
+ * \param action 指令的第一個token
+ * \return 指令種類
+ */
+static CommandAction ParseCommandAction(const CommandToken& action)
+{
+	switch (action.size)
+	{
+	case 3:
+		if (action.Equals("Set"))
+		{
+			return CommandAction::SET;
+		}
+		break;
+	case 4:
+		if (action.Equals("Load"))
+		{
+			return CommandAction::LOAD;
+		}
+		if (action.Equals("Save"))
+		{
+			return CommandAction::SAVE;
+		}
+		if (action.Equals("Quit"))
+		{
+			return CommandAction::QUIT;
+		}
+		break;
+	case 5:
+		if (action.Equals("Print"))
+		{
+			return CommandAction::PRINT;
+		}
+		break;
+	case 6:
+		if (action.Equals("Replay"))
+		{
+			return CommandAction::REPLAY;
+		}
+		break;
+	case 9:
+		if (action.Equals("StartGame"))
+		{
+			return CommandAction::START_GAME;
+		}
+		if (action.Equals("LeftClick"))
+		{
+			return CommandAction::LEFT_CLICK;
+		}
+		break;
+	case 10:
+		if (action.Equals("RightClick"))
+		{
+			return CommandAction::RIGHT_CLICK;
+		}
+		break;
+	default:
+		break;
+	}
+	return CommandAction::UNKNOWN;
+}
+
+/**
+ * Intent : 由Print指令的第二個token判斷要印出的資訊
+ * Pre :
+ * Post :
+ * \param printTarget Print指令的第二個token
+ * \return 要印出的資訊 (不認得時為UNKNOWN)
+ */
+static BinaryPrintTarget ParsePrintTarget(const CommandToken& printTarget)
+{
+	static const struct
+	{
+		const char* name;
+		BinaryPrintTarget target;
+	} targets[] =
+	{
+		{ "GameBoard", BinaryPrintTarget::GAME_BOARD },
+		{ "GameAnswer", BinaryPrintTarget::GAME_ANSWER },
+		{ "GameState", BinaryPrintTarget::GAME_STATE },
+		{ "BombCount", BinaryPrintTarget::BOMB_COUNT },
+		{ "FlagCount", BinaryPrintTarget::FLAG_COUNT },
+		{ "OpenBlankCount", BinaryPrintTarget::OPEN_BLANK_COUNT },
+		{ "RemainBlankCount", BinaryPrintTarget::REMAIN_BLANK_COUNT },
+		{ "ChunkCount", BinaryPrintTarget::CHUNK_COUNT },
+		{ "Seed", BinaryPrintTarget::SEED },
+		{ "BoardCache", BinaryPrintTarget::BOARD_CACHE },
+	};
+
+	for (const auto& entry : targets)
+	{
+		if (printTarget.size == strlen(entry.name) && memcmp(printTarget.data, entry.name, printTarget.size) == 0)
+		{
+			return entry.target;
+		}
+	}
+	return BinaryPrintTarget::UNKNOWN;
 }
 
 /**
@@ -31,229 +168,855 @@ MineSweeperCore::~MineSweeperCore()
  * \param command 指令字串
  * \return 是否執行成功
  */
-bool MineSweeperCore::ExecuteCommand(std::string command)
+bool MineSweeperCore::ExecuteCommand(const std::string& command)
+{
+	return ExecuteCommand(command.data(), command.size());
+}
+
+/**
+ * Intent : 執行一行的指令 (直接使用呼叫端的記憶體，不複製指令字串)
+ * Pre :
+ * Post :
+ * \param command 指令字串的起始位置
+ * \param size 指令字串的長度
+ * \return 是否執行成功
+ */
+bool MineSweeperCore::ExecuteCommand(const char* command, size_t size)
 {
 	//防呆機制
-	if (command.empty())
+	if (size == 0)
 	{
 		return false;
 	}
 
-	cout << '<' << command << "> : ";
+	commandCount++;
+	output << '<';
+	output.Write(command, size);
+	output << "> : ";
 
-	//使用stringstream來分割指令
-	stringstream commandStream(command);
-	string action;
-	commandStream >> action;
+	//直接在指令字串上分割token，執行失敗以回傳值表示
+	CommandTokenizerCore tokens(command, size);
+	CommandToken action;
+	CommandResult result = tokens.Next(action) ? DispatchCommand(action, tokens) : CommandResult::FAILED;
 
-	//用try catch來將所有執行失敗的指令導到同一個地方
-	try {
+	if (result == CommandResult::FAILED)
+	{
+		//執行失敗，印出failed
+		output << "Failed" << '\n';
 
-		//Load指令
-		if (action == "Load")
+		//盤面檔格式錯誤時，接著印出錯誤位置
+		if (!loadError.empty())
 		{
-			//防呆機制
-			if (gameState != MineSweeperState::STANDBY)
-			{
-				throw - 1;
-			}
+			output << loadError << '\n';
+			loadError.clear();
+		}
+	}
+	else if (result == CommandResult::SUCCESS)
+	{
+		//執行成功，印出Success
+		output << "Success" << '\n';
+	}
 
-			string generateType;
-			commandStream >> generateType;
+	//一個回應結束，由輸出緩衝區決定是否寫出
+	output.EndResponse();
 
-			//若已經載入過盤面，則先將已有的盤面清除
-			if (gameBoard->IsLoaded())
-			{
-				gameBoard->Clear();
-			}
+	if (quitRequested && exitOnQuit)
+	{
+		ExitProgram();
+	}
+	return result != CommandResult::FAILED;
+}
 
-			if (generateType == "BoardFile")
-			{
-				string boardFilename;
-				commandStream >> boardFilename;
-				LoadFileBoard(boardFilename);
-			}
-			else if (generateType == "RandomCount")
-			{
-				int _row, _col, _bombCount;
-				commandStream >> _row >> _col >> _bombCount;
-				LoadRandomCountBoard(_row, _col, _bombCount);
-			}
-			else if (generateType == "RandomRate")
-			{
-				int _row, _col;
-				float _bombRate;
-				commandStream >> _row >> _col >> _bombRate;
-				LoadRandomRateBoard(_row, _col, _bombRate);
-			}
-			if (!gameBoard->IsLoaded())
-			{
-				throw - 1;
-			}
+/**
+ * Intent : 依指令種類執行指令
+ * Pre :
+ * Post :
+ * \param action 指令的第一個token
+ * \param tokens 指令剩下的token
+ * \return 執行結果
+ */
+CommandResult MineSweeperCore::DispatchCommand(const CommandToken& action, CommandTokenizerCore& tokens)
+{
+	switch (ParseCommandAction(action))
+	{
+	//Load指令
+	case CommandAction::LOAD:
+		return ExecuteLoad(tokens);
+
+	//StartGame指令
+	case CommandAction::START_GAME:
+		return ExecuteStartGame();
+
+	//Print指令
+	case CommandAction::PRINT:
+	{
+		CommandToken printTarget;
+		tokens.Next(printTarget);
+		BinaryPrintTarget target = ParsePrintTarget(printTarget);
+
+		//沒有邊界的盤面可以指定 top left rowCount colCount
+		long long top = 0, left = 0, rowCount = 0, colCount = 0;
+		bool hasRange = (target == BinaryPrintTarget::GAME_BOARD || target == BinaryPrintTarget::GAME_ANSWER)
+			&& tokens.NextLongLong(top) && tokens.NextLongLong(left) && tokens.NextLongLong(rowCount) && tokens.NextLongLong(colCount);
+
+		ExecutePrint(output, target, hasRange, top, left, rowCount, colCount);
+		return CommandResult::PRINTED;
+	}
+
+	//LeftClick指令
+	case CommandAction::LEFT_CLICK:
+	{
+		long long clickRow, clickCol;
+
+		//防呆機制
+		if (gameState != MineSweeperState::PLAYING || !tokens.NextLongLong(clickRow) || !tokens.NextLongLong(clickCol))
+		{
+			return CommandResult::FAILED;
 		}
-		//StartGame指令
-		else if (action == "StartGame")
+
+		return ExecuteLeftClick(clickRow, clickCol);
+	}
+
+	//RightClick指令
+	case CommandAction::RIGHT_CLICK:
+	{
+		long long clickRow, clickCol;
+
+		//防呆機制
+		if (gameState != MineSweeperState::PLAYING || !tokens.NextLongLong(clickRow) || !tokens.NextLongLong(clickCol))
 		{
-			//防呆機制
-			if (gameState != MineSweeperState::STANDBY)
-			{
-				throw - 1;
-			}
+			return CommandResult::FAILED;
+		}
 
-			if (gameBoard->IsLoaded() == false)
-			{
-				throw - 1;
-			}
+		return ExecuteRightClick(clickRow, clickCol);
+	}
+
+	//Replay指令
+	case CommandAction::REPLAY:
+		return ExecuteReplay();
 
-			StartGame();
+	//Save指令 (把目前的盤面寫成二進位盤面檔，含數字平面與種子)
+	case CommandAction::SAVE:
+	{
+		CommandToken saveType, filename;
+
+		//防呆機制
+		if (!tokens.Next(saveType) || !saveType.Equals("BoardFile") || !tokens.Next(filename))
+		{
+			return CommandResult::FAILED;
 		}
-		//Print指令
-		else if (action == "Print")
+
+		return ExecuteSave(filename.ToString());
+	}
+
+	//Set指令 (設定選項)
+	case CommandAction::SET:
+		return ExecuteSet(tokens);
+
+	//Quit指令
+	case CommandAction::QUIT:
+		return ExecuteQuit();
+
+	default:
+		return CommandResult::FAILED;
+	}
+}
+
+/**
+ * Intent : 檢查是否可以載入盤面，並清除已載入的盤面
+ * Pre :
+ * Post : 成功時兩種盤面都已清除
+ * \return 是否可以載入 (Standby狀態)
+ */
+bool MineSweeperCore::PrepareLoad()
+{
+	//防呆機制
+	if (gameState != MineSweeperState::STANDBY)
+	{
+		return false;
+	}
+
+	//若已經載入過盤面，則先將已有的盤面清除
+	if (gameBoard->IsLoaded())
+	{
+		gameBoard->Clear();
+	}
+	if (chunkBoard->IsLoaded())
+	{
+		chunkBoard->Clear();
+	}
+	return true;
+}
+
+/**
+ * Intent : 執行StartGame指令
+ * Pre :
+ * Post : 成功時進入Playing狀態
+ * \return 執行結果
+ */
+CommandResult MineSweeperCore::ExecuteStartGame()
+{
+	//防呆機制
+	if (gameState != MineSweeperState::STANDBY)
+	{
+		return CommandResult::FAILED;
+	}
+
+	if (IsBoardLoaded() == false)
+	{
+		return CommandResult::FAILED;
+	}
+
+	StartGame();
+	return CommandResult::SUCCESS;
+}
+
+/**
+ * Intent : 執行LeftClick指令
+ * Pre :
+ * Post : 成功時開啟格子，可能導致遊戲結束
+ * \param row row位置
+ * \param col col位置
+ * \return 執行結果
+ */
+CommandResult MineSweeperCore::ExecuteLeftClick(long long row, long long col)
+{
+	//防呆機制
+	if (gameState != MineSweeperState::PLAYING || !ValidRowCol(row, col))
+	{
+		return CommandResult::FAILED;
+	}
+
+	CellState cellState = GetBoardCell(row, col)->GetState();
+
+	//防呆機制
+	if (cellState == CellState::FLAGGED || cellState == CellState::OPENED)
+	{
+		return CommandResult::FAILED;
+	}
+
+	//文字回應先印出Success，之後才是遊戲結束的訊息
+	if (textResponse)
+	{
+		output << "Success" << '\n';
+	}
+	LeftClick(row, col);
+	return CommandResult::PRINTED;
+}
+
+/**
+ * Intent : 執行RightClick指令
+ * Pre :
+ * Post : 成功時標註格子
+ * \param row row位置
+ * \param col col位置
+ * \return 執行結果
+ */
+CommandResult MineSweeperCore::ExecuteRightClick(long long row, long long col)
+{
+	//防呆機制
+	if (gameState != MineSweeperState::PLAYING || !ValidRowCol(row, col))
+	{
+		return CommandResult::FAILED;
+	}
+
+	CellState cellState = GetBoardCell(row, col)->GetState();
+
+	//防呆機制
+	if (cellState == CellState::OPENED)
+	{
+		return CommandResult::FAILED;
+	}
+
+	RightClick(row, col);
+	return CommandResult::SUCCESS;
+}
+
+/**
+ * Intent : 執行Replay指令
+ * Pre :
+ * Post : 成功時回到Standby狀態
+ * \return 執行結果
+ */
+CommandResult MineSweeperCore::ExecuteReplay()
+{
+	//防呆機制
+	if (gameState != MineSweeperState::GAMEOVER)
+	{
+		return CommandResult::FAILED;
+	}
+
+	Replay();
+	return CommandResult::SUCCESS;
+}
+
+/**
+ * Intent : 執行Save BoardFile指令，把目前的盤面寫成二進位盤面檔 (含數字平面與種子)
+ * Pre :
+ * Post : 成功時盤面檔寫入完成
+ * \param filename 盤面檔檔名
+ * \return 執行結果
+ */
+CommandResult MineSweeperCore::ExecuteSave(const std::string& filename)
+{
+	//防呆機制
+	if (boardType == BoardCoreGenerateType::INFINITE_RATE || !gameBoard->IsLoaded())
+	{
+		return CommandResult::FAILED;
+	}
+
+	if (!BoardFileCore::SaveBinaryBoard(filename, *gameBoard, boardSeed, true))
+	{
+		return CommandResult::FAILED;
+	}
+	return CommandResult::SUCCESS;
+}
+
+/**
+ * Intent : 執行Quit指令
+ * Pre :
+ * Post : 成功時標記為已Quit，由呼叫端在回應寫出後決定是否結束整個程式
+ * \return 執行結果
+ */
+CommandResult MineSweeperCore::ExecuteQuit()
+{
+	//防呆機制
+	if (gameState != MineSweeperState::GAMEOVER)
+	{
+		return CommandResult::FAILED;
+	}
+
+	quitRequested = true;
+	return CommandResult::SUCCESS;
+}
+
+/**
+ * Intent : 寫出緩衝區並結束整個程式 (Quit且exitOnQuit時)
+ * Pre : 回應已寫入緩衝區
+ * Post : 程式結束
+ */
+void MineSweeperCore::ExitProgram()
+{
+	//exit不會經過指令檔模式的flush point，先把緩衝區的內容寫出
+	output.Flush();
+	this->~MineSweeperCore();
+	exit(0);
+}
+
+/**
+ * Intent : 執行Load指令
+ * Pre :
+ * Post : 成功時盤面載入完成
+ * \param tokens 指令剩下的token (載入模式與參數)
+ * \return 執行結果
+ */
+CommandResult MineSweeperCore::ExecuteLoad(CommandTokenizerCore& tokens)
+{
+	//防呆機制
+	if (!PrepareLoad())
+	{
+		return CommandResult::FAILED;
+	}
+
+	CommandToken generateType;
+	tokens.Next(generateType);
+
+	if (generateType.Equals("BoardFile"))
+	{
+		CommandToken boardFilename;
+		if (tokens.Next(boardFilename))
 		{
-			string printTarget;
-			commandStream >> printTarget;
-			ExecutePrint(printTarget);
+			boardPath.assign(boardFilename.data, boardFilename.size);
+			LoadFileBoard(boardPath);
 		}
-		//LeftClick指令
-		else if (action == "LeftClick")
+	}
+	else if (generateType.Equals("RandomCount"))
+	{
+		int _row, _col, _bombCount;
+		if (tokens.NextInt(_row) && tokens.NextInt(_col) && tokens.NextInt(_bombCount))
 		{
-			//防呆機制
-			if (gameState != MineSweeperState::PLAYING)
-			{
-				throw - 1;
-			}
+			LoadRandomCountBoard(_row, _col, _bombCount, ReadSeed(tokens));
+		}
+	}
+	else if (generateType.Equals("RandomRate"))
+	{
+		int _row, _col;
+		float _bombRate;
+		if (tokens.NextInt(_row) && tokens.NextInt(_col) && tokens.NextFloat(_bombRate))
+		{
+			LoadRandomRateBoard(_row, _col, _bombRate, ReadSeed(tokens));
+		}
+	}
+	else if (generateType.Equals("Infinite"))
+	{
+		float _bombRate;
+		if (tokens.NextFloat(_bombRate))
+		{
+			LoadInfiniteBoard(_bombRate, ReadSeed(tokens));
+		}
+	}
 
-			int clickRow, clickCol;
-			commandStream >> clickRow >> clickCol;
+	return IsBoardLoaded() ? CommandResult::SUCCESS : CommandResult::FAILED;
+}
 
-			//防呆機制
-			if (!ValidRowCol(clickRow, clickCol))
-			{
-				throw - 1;
-			}
+/**
+ * Intent : 執行二進位的Load指令
+ * Pre :
+ * Post : 成功時盤面載入完成
+ * \param request 指令 (option為盤面種類)
+ * \param path 盤面檔檔名 (長度為request.count)
+ * \return 執行結果
+ */
+CommandResult MineSweeperCore::ExecuteBinaryLoad(const BinaryRequest& request, const char* path)
+{
+	//防呆機制
+	if (!PrepareLoad())
+	{
+		return CommandResult::FAILED;
+	}
 
-			CellState cellState = gameBoard->GetCell(clickRow, clickCol)->GetState();
+	//與文字指令相同 : 盤面大小與炸彈數為int，炸彈機率必須是有限的數字，沒有指定種子時產生新的種子
+	bool hasSeed = (request.flags & BinaryProtocolCore::FLAG_SEED) != 0;
+	bool validSize = request.rowCount >= INT_MIN && request.rowCount <= INT_MAX && request.colCount >= INT_MIN && request.colCount <= INT_MAX;
+	bool validRate = std::isfinite(request.rate);
 
-			//防呆機制
-			if (cellState == CellState::FLAGGED || cellState == CellState::OPENED)
-			{
-				throw - 1;
-			}
+	switch ((BinaryLoadType)request.option)
+	{
+	case BinaryLoadType::BOARD_FILE:
+		if (request.count > 0)
+		{
+			boardPath.assign(path, (size_t)request.count);
+			LoadFileBoard(boardPath);
+		}
+		break;
+	case BinaryLoadType::RANDOM_COUNT:
+		if (validSize && request.count >= INT_MIN && request.count <= INT_MAX)
+		{
+			LoadRandomCountBoard((int)request.rowCount, (int)request.colCount, (int)request.count, hasSeed ? request.seed : RandomCore::RandomSeed());
+		}
+		break;
+	case BinaryLoadType::RANDOM_RATE:
+		if (validSize && validRate)
+		{
+			LoadRandomRateBoard((int)request.rowCount, (int)request.colCount, request.rate, hasSeed ? request.seed : RandomCore::RandomSeed());
+		}
+		break;
+	case BinaryLoadType::INFINITE_RATE:
+		if (validRate)
+		{
+			LoadInfiniteBoard(request.rate, hasSeed ? request.seed : RandomCore::RandomSeed());
+		}
+		break;
+	default:
+		break;
+	}
+
+	return IsBoardLoaded() ? CommandResult::SUCCESS : CommandResult::FAILED;
+}
 
-			cout << "Success" << endl;
-			LeftClick(clickRow, clickCol);
-			return true;
+/**
+ * Intent : 執行二進位的Set指令
+ * Pre :
+ * Post : 成功時設定完成
+ * \param request 指令 (option為選項，count為值)
+ * \return 執行結果
+ */
+CommandResult MineSweeperCore::ExecuteBinarySet(const BinaryRequest& request)
+{
+	switch ((BinarySetOption)request.option)
+	{
+	case BinarySetOption::THREAD_COUNT:
+		//防呆機制
+		if (request.count < 1 || request.count > INT_MAX)
+		{
+			return CommandResult::FAILED;
 		}
-		//RightClick指令
-		else if (action == "RightClick")
+		SetThreadCount((int)request.count);
+		break;
+	case BinarySetOption::FIRST_CLICK_SAFE:
+		//防呆機制
+		if (request.count != 0 && request.count != 1)
 		{
-			if (gameState != MineSweeperState::PLAYING)
-			{
-				throw - 1;
-			}
-			int clickRow, clickCol;
-			commandStream >> clickRow >> clickCol;
+			return CommandResult::FAILED;
+		}
+		SetFirstClickSafe(request.count == 1);
+		break;
+	case BinarySetOption::FLOOD_FILL:
+		//防呆機制
+		if (request.count < (long long)FloodFillMode::QUEUE || request.count > (long long)FloodFillMode::COMPONENT)
+		{
+			return CommandResult::FAILED;
+		}
+		SetFloodFillMode((FloodFillMode)request.count);
+		break;
+	default:
+		return CommandResult::FAILED;
+	}
+	return CommandResult::SUCCESS;
+}
 
-			//防呆機制
-			if (!ValidRowCol(clickRow, clickCol))
-			{
-				throw - 1;
-			}
+/**
+ * Intent : 寫出二進位回應 : header、變更格子的位置、變更格子的字元、Print內容
+ * Pre : changeLog與payloadBuffer為這個指令的結果
+ * Post :
+ * \param opcode 指令種類
+ * \param success 是否執行成功
+ */
+void MineSweeperCore::WriteBinaryResponse(BinaryOpcode opcode, bool success)
+{
+	bool infinite = boardType == BoardCoreGenerateType::INFINITE_RATE;
+
+	BinaryResponse response;
+	response.status = success ? 1 : 0;
+	response.state = (std::uint8_t)gameState;
+	response.outcome = gameState != MineSweeperState::GAMEOVER ? 0 : (playerWin ? 1 : 2);
+	response.opcode = opcode;
+	response.changeCount = (std::uint32_t)changeLog.size();
+	response.payloadSize = payloadBuffer.size();
+	response.bombCount = infinite ? chunkBoard->GetTotalBombCount() : gameBoard->GetTotalBombCount();
+	response.flagCount = infinite ? chunkBoard->GetTotalFlagCount() : gameBoard->GetTotalFlagCount();
+	response.openBlankCount = infinite ? chunkBoard->GetOpenBlankCount() : gameBoard->GetOpenBlankCount();
+	response.remainBlankCount = infinite ? chunkBoard->GetRemainBlankCount() : gameBoard->GetRemainBlankCount();
+
+	BinaryProtocolCore::EncodeResponse(response, reinterpret_cast<unsigned char*>(output.Reserve(BinaryProtocolCore::RESPONSE_SIZE)));
+	output.Commit(BinaryProtocolCore::RESPONSE_SIZE);
+
+	for (size_t i = 0; i < changeLog.size(); i++)
+	{
+		BinaryProtocolCore::EncodeChange(changeLog[i], reinterpret_cast<unsigned char*>(output.Reserve(BinaryProtocolCore::CHANGE_SIZE)));
+		output.Commit(BinaryProtocolCore::CHANGE_SIZE);
+	}
 
-			CellState cellState = gameBoard->GetCell(clickRow, clickCol)->GetState();
+	//格子目前顯示的字元 (與Print GameBoard相同)
+	for (size_t i = 0; i < changeLog.size(); i++)
+	{
+		output << GetBoardCell(changeLog[i].row, changeLog[i].col)->GetChar();
+	}
 
-			//防呆機制
-			if (cellState == CellState::OPENED)
-			{
-				throw - 1;
-			}
+	output.Write(payloadBuffer.data(), payloadBuffer.size());
+}
 
-			RightClick(clickRow, clickCol);
-		}
-		//Replay指令
-		else if (action == "Replay")
+/**
+ * Intent : 執行Set指令
+ * Pre :
+ * Post : 成功時設定完成
+ * \param tokens 指令剩下的token (選項名稱與值)
+ * \return 執行結果
+ */
+CommandResult MineSweeperCore::ExecuteSet(CommandTokenizerCore& tokens)
+{
+	CommandToken optionName;
+	tokens.Next(optionName);
+
+	if (optionName.Equals("ThreadCount"))
+	{
+		int _threadCount = 0;
+
+		//防呆機制
+		if (!tokens.NextInt(_threadCount) || _threadCount < 1)
 		{
-			//防呆機制
-			if (gameState != MineSweeperState::GAMEOVER)
-			{
-				throw - 1;
-			}
+			return CommandResult::FAILED;
+		}
 
-			Replay();
+		SetThreadCount(_threadCount);
+	}
+	else if (optionName.Equals("FirstClickSafe"))
+	{
+		CommandToken optionValue;
+		tokens.Next(optionValue);
+
+		if (optionValue.Equals("On"))
+		{
+			SetFirstClickSafe(true);
 		}
-		//Quit指令
-		else if (action == "Quit")
+		else if (optionValue.Equals("Off"))
 		{
-			//防呆機制
-			if (gameState != MineSweeperState::GAMEOVER)
-			{
-				throw - 1;
-			}
+			SetFirstClickSafe(false);
+		}
+		else
+		{
+			return CommandResult::FAILED;
+		}
+	}
+	else if (optionName.Equals("FloodFill"))
+	{
+		CommandToken optionValue;
+		tokens.Next(optionValue);
 
-			this->~MineSweeperCore();
-			cout << "Success" << endl;
-			exit(0);
+		if (optionValue.Equals("Queue"))
+		{
+			SetFloodFillMode(FloodFillMode::QUEUE);
+		}
+		else if (optionValue.Equals("Bitboard"))
+		{
+			SetFloodFillMode(FloodFillMode::BITBOARD);
+		}
+		else if (optionValue.Equals("Scanline"))
+		{
+			SetFloodFillMode(FloodFillMode::SCANLINE);
+		}
+		else if (optionValue.Equals("Component"))
+		{
+			SetFloodFillMode(FloodFillMode::COMPONENT);
 		}
 		else
 		{
-			throw - 1;
+			return CommandResult::FAILED;
+		}
+	}
+	else
+	{
+		return CommandResult::FAILED;
+	}
+
+	return CommandResult::SUCCESS;
+}
+
+/**
+ * Intent : 執行多行的指令
+ * Pre :
+ * Post :
+ * \param commandArray 指令字串陣列
+ */
+void MineSweeperCore::ExecuteCommands(const std::vector<std::string>& commandArray)
+{
+	//批次執行時不在每個回應後flush，累積成大區塊再寫出
+	bool autoFlush = output.GetAutoFlush();
+	output.SetAutoFlush(false);
+
+	for (size_t i = 0; i < commandArray.size() && !quitRequested; i++)
+	{
+		ExecuteCommand(commandArray[i]);
+	}
+
+	output.SetAutoFlush(autoFlush);
+	output.Flush();
+}
+/**
+ * Intent : 以固定大小的區塊串流讀取指令檔，每讀到完整的一行就直接執行，記憶體用量與檔案大小無關
+ * Pre :
+ * Post :
+ * \param filename 指令檔檔名
+ * \return 是否成功開啟指令檔
+ */
+bool MineSweeperCore::ExecuteCommandFile(std::string filename)
+{
+	ifstream commandFile(filename);
+
+	//防呆機制
+	if (!commandFile.is_open())
+	{
+		return false;
+	}
+
+	//批次執行時不在每個回應後flush，累積成大區塊再寫出
+	bool autoFlush = output.GetAutoFlush();
+	output.SetAutoFlush(false);
+
+	//區塊內完整的行直接在buffer上執行，最後不完整的一行搬到buffer開頭，與下一個區塊接起來
+	vector<char> buffer(COMMAND_CHUNK_SIZE);
+	size_t pending = 0;
+
+	while (commandFile && !quitRequested)
+	{
+		//單一行比buffer還長時才放大buffer
+		if (pending == buffer.size())
+		{
+			buffer.resize(buffer.size() * 2);
+		}
+
+		commandFile.read(buffer.data() + pending, buffer.size() - pending);
+		size_t filled = pending + (size_t)commandFile.gcount();
+		if (filled == pending)
+		{
+			break;
+		}
+
+		const char* lineStart = buffer.data();
+		const char* chunkEnd = buffer.data() + filled;
+		const char* newline;
+		while (!quitRequested && (newline = static_cast<const char*>(memchr(lineStart, '\n', chunkEnd - lineStart))) != nullptr)
+		{
+			ExecuteCommand(lineStart, newline - lineStart);
+			lineStart = newline + 1;
+		}
+
+		pending = chunkEnd - lineStart;
+		memmove(buffer.data(), lineStart, pending);
+	}
+
+	//最後一行沒有換行
+	if (pending > 0 && !quitRequested)
+	{
+		ExecuteCommand(buffer.data(), pending);
+	}
+
+	output.SetAutoFlush(autoFlush);
+	output.Flush();
+	return true;
+}
+
+/**
+ * Intent : 執行一個二進位指令，回應以二進位格式寫到輸出 (與ExecuteCommand執行相同的指令)
+ * Pre :
+ * Post :
+ * \param request 指令
+ * \param path 接在frame之後的檔名 (Load BoardFile、Save使用，長度為request.count)
+ * \return 是否執行成功
+ */
+bool MineSweeperCore::ExecuteBinaryCommand(const BinaryRequest& request, const char* path)
+{
+	commandCount++;
+
+	//回應中不含文字訊息，遊戲結果與變更的格子由header與格子清單表示
+	textResponse = false;
+	changeLog.clear();
+	payloadBuffer.clear();
+
+	CommandResult result = CommandResult::FAILED;
+	switch (request.opcode)
+	{
+	case BinaryOpcode::LOAD:
+		result = ExecuteBinaryLoad(request, path);
+
+		//盤面檔格式錯誤時，錯誤位置放在payload
+		if (!loadError.empty())
+		{
+			payloadBuffer.assign(loadError.begin(), loadError.end());
+			loadError.clear();
+		}
+		break;
+	case BinaryOpcode::START_GAME:
+		result = ExecuteStartGame();
+		break;
+	case BinaryOpcode::PRINT:
+	{
+		//Print的內容與文字回應相同，先寫進payload才能知道大小
+		BinaryPrintTarget target = request.option < (std::uint8_t)BinaryPrintTarget::UNKNOWN ? (BinaryPrintTarget)request.option : BinaryPrintTarget::UNKNOWN;
+		ExecutePrint(payloadSink, target, (request.flags & BinaryProtocolCore::FLAG_RANGE) != 0, request.row, request.col, request.rowCount, request.colCount);
+		payloadSink.Flush();
+		result = CommandResult::PRINTED;
+		break;
+	}
+	case BinaryOpcode::LEFT_CLICK:
+	case BinaryOpcode::RIGHT_CLICK:
+	{
+		//點擊時記錄被改變的格子
+		gameBoard->SetChangeLog(&changeLog);
+		chunkBoard->SetChangeLog(&changeLog);
+		bool left = request.opcode == BinaryOpcode::LEFT_CLICK;
+		result = left ? ExecuteLeftClick(request.row, request.col) : ExecuteRightClick(request.row, request.col);
+		gameBoard->SetChangeLog(nullptr);
+		chunkBoard->SetChangeLog(nullptr);
+
+		//踩到炸彈時被點擊的格子由UncoverAll開啟，也列入變更
+		if (left && result != CommandResult::FAILED && gameState == MineSweeperState::GAMEOVER && !playerWin)
+		{
+			changeLog.push_back({ request.row, request.col });
+		}
+		break;
+	}
+	case BinaryOpcode::REPLAY:
+		result = ExecuteReplay();
+		break;
+	case BinaryOpcode::SAVE:
+		result = request.count > 0 ? ExecuteSave(std::string(path, (size_t)request.count)) : CommandResult::FAILED;
+		break;
+	case BinaryOpcode::SET:
+		result = ExecuteBinarySet(request);
+		break;
+	case BinaryOpcode::QUIT:
+		result = ExecuteQuit();
+		break;
+	default:
+		break;
+	}
+
+	textResponse = true;
+	WriteBinaryResponse(request.opcode, result != CommandResult::FAILED);
+	output.EndResponse();
+
+	if (quitRequested && exitOnQuit)
+	{
+		ExitProgram();
+	}
+	return result != CommandResult::FAILED;
+}
+
+/**
+ * Intent : 從stream讀取二進位指令並依序執行，直到stream結束、Quit或遇到不合法的frame
+ * Pre : stream為binary模式
+ * Post :
+ * \param input 輸入的stream
+ */
+void MineSweeperCore::ExecuteBinaryStream(std::istream& input)
+{
+	bool autoFlush = output.GetAutoFlush();
+	output.SetAutoFlush(false);
+
+	vector<unsigned char> frame(BinaryProtocolCore::REQUEST_SIZE + (size_t)BinaryProtocolCore::MAX_PATH_SIZE);
+	while (!quitRequested && input.read(reinterpret_cast<char*>(frame.data()), BinaryProtocolCore::REQUEST_SIZE))
+	{
+		BinaryRequest request;
+		size_t frameSize = 0;
+		BinaryFrameStatus status = BinaryProtocolCore::ParseRequest(frame.data(), BinaryProtocolCore::REQUEST_SIZE, request, frameSize);
+
+		//frame之後還有檔名
+		if (status == BinaryFrameStatus::INCOMPLETE)
+		{
+			input.read(reinterpret_cast<char*>(frame.data()) + BinaryProtocolCore::REQUEST_SIZE, frameSize - BinaryProtocolCore::REQUEST_SIZE);
+			status = input ? BinaryFrameStatus::COMPLETE : BinaryFrameStatus::INCOMPLETE;
+		}
+
+		//不合法的frame之後的資料無法對齊，回應錯誤後停止執行
+		if (status != BinaryFrameStatus::COMPLETE)
+		{
+			RejectBinaryFrame(status);
+			break;
+		}
+
+		ExecuteBinaryCommand(request, reinterpret_cast<const char*>(frame.data()) + BinaryProtocolCore::REQUEST_SIZE);
+
+		//沒有已經到達的指令時才寫出，一次送來多個指令時整批寫出
+		if (input.rdbuf()->in_avail() <= 0)
+		{
+			output.Flush();
 		}
-
-	}
-	catch (int failed)
-	{
-		//執行失敗，印出failed
-		cout << "Failed" << endl;
-		return false;
 	}
 
-	if (action != "Print")
+	//結尾殘留不足一個frame的資料
+	if (!quitRequested && input.gcount() > 0 && input.eof())
 	{
-		//執行成功，印出Success
-		cout << "Success" << endl;
+		RejectBinaryFrame(BinaryFrameStatus::INCOMPLETE);
 	}
 
-	return true;
+	output.SetAutoFlush(autoFlush);
+	output.Flush();
 }
 
 /**
- * Intent : 執行多行的指令
- * Pre :
- * Post :
- * \param commandArray 指令字串陣列
- */
-void MineSweeperCore::ExecuteCommands(std::vector<std::string> commandArray)
-{
-	for (int i = 0; i < commandArray.size(); i++)
-	{
-		ExecuteCommand(commandArray[i]);
-	}
-}
-/**
- * Intent : 讀取並執行指令檔
- * Pre :
- * Post :
- * \param filename 指令檔檔名
+ * Intent : 回應一個無法執行的frame : status為0、opcode為INVALID，payload為錯誤說明
+ * Pre : status為INVALID或INCOMPLETE
+ * Post : 回應寫到輸出，不計入已執行的指令數量
+ * \param status 解析frame的結果
  */
-void MineSweeperCore::ExecuteCommandFile(std::string filename)
+void MineSweeperCore::RejectBinaryFrame(BinaryFrameStatus status)
 {
-	ifstream commandFile(filename);
+	static const char invalidMessage[] = "Invalid binary command frame";
+	static const char incompleteMessage[] = "Incomplete binary command frame";
 
-	//防呆機制
-	if (!commandFile.is_open())
+	changeLog.clear();
+	if (status == BinaryFrameStatus::INCOMPLETE)
 	{
-		return;
+		payloadBuffer.assign(incompleteMessage, incompleteMessage + sizeof(incompleteMessage) - 1);
 	}
-
-	vector<string> commands;
-	string line;
-
-	while (getline(commandFile, line))
+	else
 	{
-		commands.push_back(line);
+		payloadBuffer.assign(invalidMessage, invalidMessage + sizeof(invalidMessage) - 1);
 	}
 
-	ExecuteCommands(commands);
+	WriteBinaryResponse(BinaryOpcode::INVALID, false);
+	output.EndResponse();
 }
 
 /**
@@ -381,6 +1144,144 @@ int MineSweeperCore::GetRemainBlankCount()
 	return gameBoard->GetRemainBlankCount();
 }
 
+/**
+ * Intent : 設定盤面整盤運算 (Refresh、UncoverAll、隨機產生) 最多使用的執行緒數量
+ * Pre :
+ * Post : 設定完成
+ * \param threadCount 執行緒數量
+ */
+void MineSweeperCore::SetThreadCount(int threadCount)
+{
+	gameBoard->SetThreadCount(threadCount);
+}
+
+/**
+ * Intent : 設定是否啟用第一次點擊安全模式 (隨機盤面的第一次LeftClick必定開出0)
+ * Pre :
+ * Post : 設定完成，下一次StartGame後生效
+ * \param enable 是否啟用
+ */
+void MineSweeperCore::SetFirstClickSafe(bool enable)
+{
+	firstClickSafe = enable;
+}
+
+/**
+ * Intent : 設定LeftClick開啟區域時使用的flood fill實作方式
+ * Pre :
+ * Post : 設定完成
+ * \param mode flood fill的實作方式
+ */
+void MineSweeperCore::SetFloodFillMode(FloodFillMode mode)
+{
+	gameBoard->SetFloodFillMode(mode);
+}
+
+/**
+ * Intent : 設定Quit指令是否結束整個程式，關閉時Quit只結束這個遊戲 (批次執行、多個遊戲共用一個程式時使用)
+ * Pre :
+ * Post : 設定完成
+ * \param enable 是否結束整個程式
+ */
+void MineSweeperCore::SetExitOnQuit(bool enable)
+{
+	exitOnQuit = enable;
+}
+
+/**
+ * Intent : 設定Print GameBoard/GameAnswer最多印出的格子數，範圍超過時不印出 (伺服器限制一個回應的大小時使用)
+ * Pre :
+ * Post : 設定完成
+ * \param limit 格子數上限
+ */
+void MineSweeperCore::SetPrintCellLimit(long long limit)
+{
+	printCellLimit = limit;
+}
+
+/**
+ * Intent : 是否已經成功執行過Quit指令 (只在Quit不結束整個程式時有意義)
+ * Pre :
+ * Post :
+ * \return 是否已經執行過Quit
+ */
+bool MineSweeperCore::IsQuit()
+{
+	return quitRequested;
+}
+
+/**
+ * Intent : 回傳已執行的指令數量 (不含空白行)
+ * Pre :
+ * Post :
+ * \return 已執行的指令數量
+ */
+long long MineSweeperCore::GetCommandCount()
+{
+	return commandCount;
+}
+
+/**
+ * Intent : 回到剛建立時的狀態並改用新的輸出 (SessionPoolCore重複使用實例時呼叫)，盤面記憶體保留重複使用
+ * Pre :
+ * Post : Standby狀態，設定回到預設值，未寫出的輸出直接捨棄
+ * \param outputWriter 新的輸出callback
+ */
+void MineSweeperCore::Reset(OutputSinkCore::Writer outputWriter)
+{
+	output.Reset(outputWriter);
+
+	//Clear只清除盤面資訊，格子記憶體留給下一局，只有超過上限時才釋放
+	Clear();
+	gameBoard->ShrinkMem(RESET_RETAIN_BYTES);
+	chunkBoard->ShrinkMem(RESET_RETAIN_BYTES);
+	output.ShrinkMem(RESET_RETAIN_BYTES);
+	payloadSink.ShrinkMem(RESET_RETAIN_BYTES);
+
+	//設定回到與建立時相同的預設值
+	gameBoard->SetThreadCount(ThreadPoolCore::HardwareThreadCount());
+	gameBoard->SetFloodFillMode(FloodFillMode::QUEUE);
+	gameBoard->SetChangeLog(nullptr);
+	chunkBoard->SetChangeLog(nullptr);
+	rows = 9;
+	cols = 9;
+	playerWin = false;
+	boardSeed = 0;
+	boardType = BoardCoreGenerateType::FILE;
+	firstClickSafe = false;
+	firstClickPending = false;
+	exitOnQuit = true;
+	quitRequested = false;
+	commandCount = 0;
+	printCellLimit = LLONG_MAX;
+	textResponse = true;
+	loadError.clear();
+	changeLog.clear();
+	payloadBuffer.clear();
+
+	//二進位指令的變更紀錄在大範圍flood fill後可能很大
+	if (changeLog.capacity() * sizeof(CellChange) > RESET_RETAIN_BYTES)
+	{
+		vector<CellChange>().swap(changeLog);
+	}
+	if (payloadBuffer.capacity() > RESET_RETAIN_BYTES)
+	{
+		vector<char>().swap(payloadBuffer);
+	}
+}
+
+/**
+ * Intent : 回傳盤面、flood fill與輸出的buffer保留的記憶體大小 (含未使用的容量)
+ * Pre :
+ * Post :
+ * \return 保留的byte數
+ */
+size_t MineSweeperCore::GetRetainedMemorySize() const
+{
+	return gameBoard->GetRetainedMemorySize() + chunkBoard->GetRetainedMemorySize() + output.GetRetainedMemorySize()
+		+ payloadSink.GetRetainedMemorySize() + changeLog.capacity() * sizeof(CellChange) + payloadBuffer.capacity() + loadError.capacity() + boardPath.capacity();
+}
+
 /**
  * Intent : 重新設定row col的數量
  * Pre : 並非處於Playing狀態中
@@ -398,96 +1299,93 @@ void MineSweeperCore::ResetRowCol(int _rows, int _cols)
 }
 
 /**
- * Intent : 動態配置記憶體，產生bomb map (2維bool陣列)
+ * Intent : 讀取Load指令最後的隨機種子參數，沒有指定時產生一個新的種子
  * Pre :
- * Post : 記憶體配置完成
- * \param rows row數量
- * \param cols col數量
- * \return bomb map陣列指標
- */
-bool** MineSweeperCore::NewBombMap(int rows, int cols)
-{
-	bool** isBombMap = new bool* [rows];
-	for (int i = 0; i < rows; i++)
-	{
-		isBombMap[i] = new bool[cols];
-	}
-	return isBombMap;
-}
-
-/**
- * Intent : 釋放bomb map的記憶體
- * Pre : 記憶體配置完成
- * Post : 釋放完成
- * \param isBombMap bomb map陣列指標
- * \param rows row數量
+ * Post :
+ * \param tokens 指令剩下的token
+ * \return 隨機種子
  */
-void MineSweeperCore::DelBombMap(bool** isBombMap, int rows)
+std::uint64_t MineSweeperCore::ReadSeed(CommandTokenizerCore& tokens)
 {
-	for (int i = 0; i < rows; i++)
+	std::uint64_t seed;
+	if (tokens.NextUInt64(seed))
 	{
-		delete[] isBombMap[i];
+		return seed;
 	}
-	delete[] isBombMap;
+	return RandomCore::RandomSeed();
 }
 
 /**
  * Intent : 用盤面檔模式來載入
  * Pre :
- * Post : 載入完成
+ * Post : 載入完成，文字盤面檔格式錯誤時錯誤說明記錄在loadError
  * \param filename 盤面檔檔名
  */
-void MineSweeperCore::LoadFileBoard(std::string filename)
+void MineSweeperCore::LoadFileBoard(const std::string& filename)
 {
+	loadError.clear();
+
 	//防呆機制
 	if (gameState == MineSweeperState::PLAYING)
 	{
 		return;
 	}
 
-	std::ifstream mapFile(filename);
-
-	if (!mapFile.is_open())
+	//盤面檔沒有被修改過時，直接複製快取中已計算好的盤面
+	BoardCacheCore::FileStamp stamp;
+	if (!BoardCacheCore::GetFileStamp(filename, stamp))
 	{
 		return;
 	}
 
-	mapFile >> rows >> cols;
+	std::uint64_t cachedSeed = 0;
+	if (BoardCacheCore::Instance().Fetch(filename, stamp, *gameBoard, cachedSeed))
+	{
+		boardSeed = cachedSeed;
+		rows = gameBoard->GetRowCount();
+		cols = gameBoard->GetColCount();
+		boardType = BoardCoreGenerateType::FILE;
+		return;
+	}
 
-	//創建bomb map
-	bool** isBombMap = NewBombMap(rows, cols);
+	MappedFileCore mapFile;
 
-	//讀掉換行字元
-	mapFile.ignore();
+	if (!mapFile.Open(filename))
+	{
+		return;
+	}
 
-	//讀取盤面檔
-	for (int i = 0; i < rows; i++)
+	//二進位盤面檔直接由映射的記憶體載入，否則以文字格式讀取
+	if (BoardFileCore::IsBinaryBoard(mapFile.GetData(), mapFile.GetSize()))
 	{
-		char cellChar;
-		for (int j = 0; j < cols; j++)
+		std::uint64_t seed = 0;
+		if (!BoardFileCore::LoadBinaryBoard(mapFile.GetData(), mapFile.GetSize(), *gameBoard, seed))
 		{
-			mapFile >> cellChar;
-
-			if (cellChar == 'O')
-			{
-				isBombMap[i][j] = false;
-			}
-			else if (cellChar == 'X')
-			{
-				isBombMap[i][j] = true;
-			}
+			return;
+		}
 
+		//記錄檔案中的種子，Print Seed可以取得產生這個盤面的種子
+		boardSeed = seed;
+	}
+	else
+	{
+		//格式錯誤時記錄錯誤位置，由指令的回應印出 (指令本身仍然回報Failed)
+		std::string error;
+		if (!BoardFileCore::LoadTextBoard(mapFile.GetData(), mapFile.GetSize(), *gameBoard, error))
+		{
+			loadError = filename + ": " + error;
+			return;
 		}
 
-		//讀掉換行字元
-		mapFile.ignore();
+		//文字盤面檔沒有種子
+		boardSeed = 0;
 	}
 
-	//把bomb map丟給BoardCore的載入函式
-	gameBoard->Load(isBombMap, rows, cols);
+	BoardCacheCore::Instance().Store(filename, stamp, *gameBoard, boardSeed);
 
-	//釋放記憶體
-	DelBombMap(isBombMap, rows);
+	rows = gameBoard->GetRowCount();
+	cols = gameBoard->GetColCount();
+	boardType = BoardCoreGenerateType::FILE;
 }
 
 /**
@@ -497,8 +1395,9 @@ void MineSweeperCore::LoadFileBoard(std::string filename)
  * \param _rows row數量
  * \param _cols col數量
  * \param bombCount 指令炸彈數量
+ * \param seed 隨機種子
  */
-void MineSweeperCore::LoadRandomCountBoard(int _rows, int _cols, int bombCount)
+void MineSweeperCore::LoadRandomCountBoard(int _rows, int _cols, int bombCount, std::uint64_t seed)
 {
 	//防呆機制
 	if (bombCount < 0 || bombCount > _rows * _cols)
@@ -518,38 +1417,12 @@ void MineSweeperCore::LoadRandomCountBoard(int _rows, int _cols, int bombCount)
 	//先載入空的盤面
 	gameBoard->Load(_rows, _cols);
 
-	//設定C++的隨機產生器
-	std::random_device rd;
-	std::mt19937 gen(rd());
-	std::uniform_int_distribution<> randRow(0, _rows - 1);
-	std::uniform_int_distribution<> randCol(0, _cols - 1);
-
-	//產生指令數量的炸彈
-	for (int i = 0; i < bombCount; i++)
-	{
-		while (true)
-		{
-			//隨機選一個位置
-			int row = randRow(gen);
-			int col = randCol(gen);
-			CellCore* cell = gameBoard->GetCell(row, col);
-
-			//如果已經是炸彈了，就繼續挑下個位置
-			if (cell->IsBomb())
-			{
-				continue;
-			}
-			else
-			{
-				//這個位置目前不是炸彈，將其設定為炸彈格
-				cell->SetBomb(true);
-				break;
-			}
-		}
-	}
+	//記錄種子，之後可以用Print Seed取得並重現盤面
+	boardSeed = seed;
+	boardType = BoardCoreGenerateType::RANDOM_COUNT;
 
-	//更新GameBoard，會計算出GameAnswer與Count
-	gameBoard->Refresh();
+	//由BoardCore用Floyd抽樣產生指定數量的炸彈，並計算count
+	gameBoard->GenerateRandomCount(bombCount, seed);
 }
 
 /**
@@ -559,8 +1432,9 @@ void MineSweeperCore::LoadRandomCountBoard(int _rows, int _cols, int bombCount)
  * \param _rows row數量
  * \param _cols col數量
  * \param bombRate 炸彈生成機率
+ * \param seed 隨機種子
  */
-void MineSweeperCore::LoadRandomRateBoard(int _rows, int _cols, float bombRate)
+void MineSweeperCore::LoadRandomRateBoard(int _rows, int _cols, float bombRate, std::uint64_t seed)
 {
 	//防呆機制
 	if (bombRate < 0.0f || bombRate > 1.0f)
@@ -577,35 +1451,76 @@ void MineSweeperCore::LoadRandomRateBoard(int _rows, int _cols, float bombRate)
 	//重設row col數量
 	ResetRowCol(_rows, _cols);
 
-	//創建bomb map
-	bool** isBombMap = NewBombMap(_rows, _cols);
+	//先載入空的盤面
+	gameBoard->Load(_rows, _cols);
+
+	//記錄種子，之後可以用Print Seed取得並重現盤面
+	boardSeed = seed;
+	boardType = BoardCoreGenerateType::RANDOM_RATE;
 
-	//設定C++的隨機產生器
-	std::random_device rd;
-	std::mt19937 gen(rd());
-	std::uniform_real_distribution<> dis(0, 1);//uniform distribution between 0 and 1
+	//由BoardCore分block平行產生炸彈，直接寫入盤面並計算count
+	gameBoard->GenerateRandomRate(bombRate, seed);
+}
 
-	//對每個格子隨機產生炸彈，放到bomb map中
-	for (int i = 0; i < _rows; i++)
+/**
+ * Intent :	用沒有邊界的區塊盤面來載入，區塊在第一次被存取時才產生
+ * Pre :
+ * Post : 載入完成
+ * \param bombRate 炸彈生成機率
+ * \param seed 隨機種子
+ */
+void MineSweeperCore::LoadInfiniteBoard(float bombRate, std::uint64_t seed)
+{
+	//防呆機制
+	if (bombRate < 0.0f || bombRate > 1.0f)
 	{
-		for (int j = 0; j < _cols; j++)
-		{
-			if (dis(gen) > bombRate)
-			{
-				isBombMap[i][j] = false;
-			}
-			else
-			{
-				isBombMap[i][j] = true;
-			}
-		}
+		return;
+	}
+
+	//防呆機制
+	if (gameState == MineSweeperState::PLAYING)
+	{
+		return;
 	}
 
-	//把bomb map丟給BoardCore的載入函式
-	gameBoard->Load(isBombMap, _rows, _cols);
+	//記錄種子，之後可以用Print Seed取得並重現盤面
+	boardSeed = seed;
+	boardType = BoardCoreGenerateType::INFINITE_RATE;
+
+	//只記錄機率與種子，區塊在被點擊、印出或查詢時才產生
+	chunkBoard->Load(bombRate, seed);
+}
+
+/**
+ * Intent : 目前的盤面是否已載入 (依載入模式選擇BoardCore或ChunkBoardCore)
+ * Pre :
+ * Post :
+ * \return 目前的盤面是否已載入
+ */
+bool MineSweeperCore::IsBoardLoaded()
+{
+	if (boardType == BoardCoreGenerateType::INFINITE_RATE)
+	{
+		return chunkBoard->IsLoaded();
+	}
+	return gameBoard->IsLoaded();
+}
 
-	//釋放記憶體
-	DelBombMap(isBombMap, _rows);
+/**
+ * Intent : 獲取目前盤面上該格的指標 (依載入模式選擇BoardCore或ChunkBoardCore)
+ * Pre : row col合法
+ * Post :
+ * \param row row位置
+ * \param col col位置
+ * \return 該格的指標
+ */
+CellCore* MineSweeperCore::GetBoardCell(long long row, long long col)
+{
+	if (boardType == BoardCoreGenerateType::INFINITE_RATE)
+	{
+		return chunkBoard->GetCell(row, col);
+	}
+	return gameBoard->GetCell((int)row, (int)col);
 }
 
 /**
@@ -616,6 +1531,7 @@ void MineSweeperCore::LoadRandomRateBoard(int _rows, int _cols, float bombRate)
 void MineSweeperCore::StartGame()
 {
 	gameState = MineSweeperState::PLAYING;
+	firstClickPending = true;
 }
 
 /**
@@ -626,6 +1542,7 @@ void MineSweeperCore::StartGame()
 void MineSweeperCore::Replay()
 {
 	gameBoard->Clear();
+	chunkBoard->Clear();
 	gameState = MineSweeperState::STANDBY;
 }
 
@@ -637,6 +1554,7 @@ void MineSweeperCore::Replay()
 void MineSweeperCore::Clear()
 {
 	gameBoard->Clear();
+	chunkBoard->Clear();
 	gameState = MineSweeperState::STANDBY;
 }
 
@@ -655,52 +1573,116 @@ bool MineSweeperCore::IsBoardExist()
  * Intent : 執行print指令
  * Pre :
  * Post :
- * \param printTarget 要印出的資訊名稱
+ * \param sink 輸出的緩衝區 (文字指令為output，二進位指令為payload)
+ * \param target 要印出的資訊
+ * \param hasRange 是否有指定範圍 (只有沒有邊界的盤面使用)
+ * \param top 範圍的左上角row
+ * \param left 範圍的左上角col
+ * \param rowCount 範圍的row數量
+ * \param colCount 範圍的col數量
  */
-void MineSweeperCore::ExecutePrint(std::string printTarget)
+void MineSweeperCore::ExecutePrint(OutputSinkCore& sink, BinaryPrintTarget target, bool hasRange, long long top, long long left, long long rowCount, long long colCount)
 {
-	if (printTarget == "GameBoard")
+	bool infinite = boardType == BoardCoreGenerateType::INFINITE_RATE;
+
+	switch (target)
 	{
-		cout << endl;
-		gameBoard->Print("\n", " ");
-	}
-	else if (printTarget == "GameAnswer")
+	case BinaryPrintTarget::GAME_BOARD:
+	case BinaryPrintTarget::GAME_ANSWER:
 	{
-		cout << endl;
-		gameBoard->PrintAnswer("\n", " ");
+		sink << '\n';
+		bool answer = target == BinaryPrintTarget::GAME_ANSWER;
+
+		if (!infinite)
+		{
+			//防呆機制 : 盤面超過上限時不印出
+			if ((long long)gameBoard->GetRowCount() * gameBoard->GetColCount() > printCellLimit)
+			{
+				return;
+			}
+
+			if (answer)
+			{
+				gameBoard->PrintAnswer(sink, "\n", " ");
+			}
+			else
+			{
+				gameBoard->Print(sink, "\n", " ");
+			}
+			return;
+		}
+
+		//沒有邊界的盤面 : 指定 top left rowCount colCount 時印出該範圍，否則印出探索過的範圍
+		if (hasRange)
+		{
+			//防呆機制 : 以減法檢查範圍的結尾，top + rowCount不會溢位
+			if (rowCount <= 0 || colCount <= 0 || !chunkBoard->ValidRowCol(top, left)
+				|| rowCount > ChunkBoardCore::COORD_LIMIT - top || colCount > ChunkBoardCore::COORD_LIMIT - left)
+			{
+				return;
+			}
+		}
+		else if (!chunkBoard->GetExploredRange(top, left, rowCount, colCount))
+		{
+			return;
+		}
+
+		//防呆機制 : 範圍太大時不印出 (探索過的範圍也可能因為點擊相距很遠的格子而變得很大)
+		long long cellLimit = printCellLimit < ChunkBoardCore::PRINT_MAX_CELLS ? printCellLimit : ChunkBoardCore::PRINT_MAX_CELLS;
+		if (rowCount > cellLimit / colCount)
+		{
+			return;
+		}
+
+		if (answer)
+		{
+			chunkBoard->PrintAnswer(sink, top, left, rowCount, colCount, "\n", " ");
+		}
+		else
+		{
+			chunkBoard->Print(sink, top, left, rowCount, colCount, "\n", " ");
+		}
+		break;
 	}
-	else if (printTarget == "GameState")
-	{
+	case BinaryPrintTarget::GAME_STATE:
 		switch (gameState)
 		{
 		case MineSweeperState::STANDBY:
-			cout << "Standby" << endl;
+			sink << "Standby" << '\n';
 			break;
 		case MineSweeperState::PLAYING:
-			cout << "Playing" << endl;
+			sink << "Playing" << '\n';
 			break;
 		case MineSweeperState::GAMEOVER:
-			cout << "GameOver" << endl;
+			sink << "GameOver" << '\n';
 			break;
 		default:
 			break;
 		}
-	}
-	else if (printTarget == "BombCount")
-	{
-		cout << gameBoard->GetTotalBombCount() << endl;
-	}
-	else if (printTarget == "FlagCount")
-	{
-		cout << gameBoard->GetTotalFlagCount() << endl;
-	}
-	else if (printTarget == "OpenBlankCount")
-	{
-		cout << gameBoard->GetOpenBlankCount() << endl;
-	}
-	else if (printTarget == "RemainBlankCount")
-	{
-		cout << gameBoard->GetRemainBlankCount() << endl;
+		break;
+	case BinaryPrintTarget::BOMB_COUNT:
+		sink << (infinite ? chunkBoard->GetTotalBombCount() : gameBoard->GetTotalBombCount()) << '\n';
+		break;
+	case BinaryPrintTarget::FLAG_COUNT:
+		sink << (infinite ? chunkBoard->GetTotalFlagCount() : gameBoard->GetTotalFlagCount()) << '\n';
+		break;
+	case BinaryPrintTarget::OPEN_BLANK_COUNT:
+		sink << (infinite ? chunkBoard->GetOpenBlankCount() : gameBoard->GetOpenBlankCount()) << '\n';
+		break;
+	case BinaryPrintTarget::REMAIN_BLANK_COUNT:
+		sink << (infinite ? chunkBoard->GetRemainBlankCount() : gameBoard->GetRemainBlankCount()) << '\n';
+		break;
+	case BinaryPrintTarget::CHUNK_COUNT:
+		sink << chunkBoard->GetChunkCount() << '\n';
+		break;
+	case BinaryPrintTarget::SEED:
+		sink << boardSeed << '\n';
+		break;
+	case BinaryPrintTarget::BOARD_CACHE:
+		sink << BoardCacheCore::Instance().GetStatus() << '\n';
+		break;
+	default:
+		break;
 	}
 }
 
@@ -711,7 +1693,7 @@ void MineSweeperCore::ExecutePrint(std::string printTarget)
  * \param row row位置
  * \param col col位置
  */
-void MineSweeperCore::LeftClick(int row, int col)
+void MineSweeperCore::LeftClick(long long row, long long col)
 {
 	//防呆機制
 	if (ValidRowCol(row, col) == false)
@@ -725,8 +1707,10 @@ void MineSweeperCore::LeftClick(int row, int col)
 		return;
 	}
 
+	bool infinite = boardType == BoardCoreGenerateType::INFINITE_RATE;
+
 	//獲取該格的指標
-	CellCore* cell = gameBoard->GetCell(row, col);
+	CellCore* cell = GetBoardCell(row, col);
 
 	//防呆機制
 	if (cell == nullptr)
@@ -741,6 +1725,20 @@ void MineSweeperCore::LeftClick(int row, int col)
 		return;
 	}
 
+	//第一次點擊安全模式 : 在第一次開啟格子前，把周遭的炸彈搬走 (只適用隨機盤面)
+	if (firstClickPending)
+	{
+		firstClickPending = false;
+		if (firstClickSafe && infinite)
+		{
+			chunkBoard->ClearBombsAround(row, col);
+		}
+		else if (firstClickSafe && boardType != BoardCoreGenerateType::FILE)
+		{
+			gameBoard->RelocateBombsAround((int)row, (int)col, boardSeed);
+		}
+	}
+
 	//如果該格是炸彈，則輸掉遊戲
 	if (cell->IsBomb())
 	{
@@ -749,28 +1747,21 @@ void MineSweeperCore::LeftClick(int row, int col)
 		return;
 	}
 
-	//設定該格為開啟狀態
-	cell->SetState(CellState::OPENED);
+	//開啟該格，若該格是0，則由flood fill一次開啟整個區域
+	if (infinite)
+	{
+		chunkBoard->FloodOpen(row, col);
+	}
+	else
+	{
+		gameBoard->FloodOpen((int)row, (int)col);
+	}
 
 	//判斷遊戲是否結束 (玩家獲勝)
 	if (IsGameFinished())
 	{
 		//呼叫獲勝後函式
 		Win();
-		return;
-	}
-
-	//如果該格是0，則往周遭8個方向的格子遞迴開啟下去
-	if (cell->GetNearBombCount() == 0)
-	{
-		LeftClick(row - 1, col - 1);
-		LeftClick(row - 1, col);
-		LeftClick(row - 1, col + 1);
-		LeftClick(row, col - 1);
-		LeftClick(row, col + 1);
-		LeftClick(row + 1, col - 1);
-		LeftClick(row + 1, col);
-		LeftClick(row + 1, col + 1);
 	}
 }
 
@@ -781,7 +1772,7 @@ void MineSweeperCore::LeftClick(int row, int col)
  * \param row row位置
  * \param col col位置
  */
-void MineSweeperCore::RightClick(int row, int col)
+void MineSweeperCore::RightClick(long long row, long long col)
 {
 	//防呆機制
 	if (gameState != MineSweeperState::PLAYING || gameBoard == nullptr)
@@ -790,7 +1781,7 @@ void MineSweeperCore::RightClick(int row, int col)
 	}
 
 	//獲取該格的指標
-	CellCore* cell = gameBoard->GetCell(row, col);
+	CellCore* cell = GetBoardCell(row, col);
 
 	//防呆機制
 	if (cell == nullptr)
@@ -805,11 +1796,15 @@ void MineSweeperCore::RightClick(int row, int col)
 		return;
 	}
 
-	//對該格執行標註
-	cell->RightClick();
-
-	//重整 (重新計算Count數)
-	gameBoard->Refresh();
+	//對該格執行標註，旗幟數量由BoardCore同步更新
+	if (boardType == BoardCoreGenerateType::INFINITE_RATE)
+	{
+		chunkBoard->RightClickCell(row, col);
+	}
+	else
+	{
+		gameBoard->RightClickCell((int)row, (int)col);
+	}
 }
 
 /**
@@ -820,10 +1815,13 @@ void MineSweeperCore::RightClick(int row, int col)
  */
 bool MineSweeperCore::IsGameFinished()
 {
-	//先重整 (重新計算Count數)
-	gameBoard->Refresh();
+	//沒有邊界的盤面永遠有未開啟的空白格子，只會因為踩到炸彈而結束
+	if (boardType == BoardCoreGenerateType::INFINITE_RATE)
+	{
+		return false;
+	}
 
-	//判斷所有空白格子是否都已被開啟
+	//count已隨格子狀態增量更新，判斷所有空白格子是否都已被開啟
 	return gameBoard->GetRemainBlankCount() == 0;
 }
 
@@ -834,12 +1832,16 @@ bool MineSweeperCore::IsGameFinished()
  */
 void MineSweeperCore::Win()
 {
-	cout << "You win the game" << endl;
+	if (textResponse)
+	{
+		output << "You win the game" << '\n';
+	}
 	gameState = MineSweeperState::GAMEOVER;
 	playerWin = true;
 
 	//將所有沒被開啟的格子打開 (顯示解答給玩家)
 	gameBoard->UncoverAll();
+	chunkBoard->UncoverAll();
 }
 
 /**
@@ -849,12 +1851,16 @@ void MineSweeperCore::Win()
  */
 void MineSweeperCore::Lose()
 {
-	cout << "You lose the game" << endl;
+	if (textResponse)
+	{
+		output << "You lose the game" << '\n';
+	}
 	gameState = MineSweeperState::GAMEOVER;
 	playerWin = false;
 
 	//將所有沒被開啟的格子打開 (顯示解答給玩家)
 	gameBoard->UncoverAll();
+	chunkBoard->UncoverAll();
 }
 
 
@@ -866,8 +1872,14 @@ void MineSweeperCore::Lose()
  * \param col 輸入的col
  * \return 輸入的row col是否合法
  */
-bool MineSweeperCore::ValidRowCol(int row, int col)
+bool MineSweeperCore::ValidRowCol(long long row, long long col)
 {
+	//沒有邊界的盤面只檢查座標上限
+	if (boardType == BoardCoreGenerateType::INFINITE_RATE)
+	{
+		return chunkBoard->ValidRowCol(row, col);
+	}
+
 	if (row < 0 || row >= rows)
 	{
 		return false;
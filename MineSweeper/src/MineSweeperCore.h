@@ -15,11 +15,20 @@
 #include <iostream>
 #include <fstream>
 #include <random>
+#include <cstdint>
 #include <vector>
 #include <sstream>
+#include <climits>
+#include <cmath>
 
 #include "CellCore.h"
 #include "BoardCore.h"
+#include "BoardCacheCore.h"
+#include "CommandTokenizerCore.h"
+#include "BoardFileCore.h"
+#include "BinaryProtocolCore.h"
+#include "ChunkBoardCore.h"
+#include "RandomCore.h"
 
  //列舉出遊戲狀態
 enum class MineSweeperState
@@ -29,12 +38,26 @@ enum class MineSweeperState
 	GAMEOVER,
 };
 
+//列舉出指令的執行結果
+enum class CommandResult
+{
+	SUCCESS, //執行成功，印出Success
+	FAILED, //執行失敗，印出Failed
+	PRINTED, //指令已自行輸出結果 (Print、LeftClick)
+};
+
 class MineSweeperCore
 {
 public:
-	//MineSweeperCore constructor
+	//MineSweeperCore constructor，輸出到std::cout
 	MineSweeperCore();
 
+	//MineSweeperCore constructor，輸出到指定的stream
+	MineSweeperCore(std::ostream&);
+
+	//MineSweeperCore constructor，輸出交給callback
+	MineSweeperCore(OutputSinkCore::Writer);
+
 	//MineSweeperCore destructor
 	~MineSweeperCore();
 
@@ -45,7 +68,17 @@ public:
 	 * \param command 指令字串
 	 * \return 是否執行成功
 	 */
-	bool ExecuteCommand(std::string);
+	bool ExecuteCommand(const std::string&);
+
+	/**
+	 * Intent : 執行一行的指令 (直接使用呼叫端的記憶體，不複製指令字串)
+	 * Pre :
+	 * Post :
+	 * \param command 指令字串的起始位置
+	 * \param size 指令字串的長度
+	 * \return 是否執行成功
+	 */
+	bool ExecuteCommand(const char*, size_t);
 
 	/**
 	 * Intent : 執行多行的指令
@@ -53,15 +86,42 @@ public:
 	 * Post :
 	 * \param commandArray 指令字串陣列
 	 */
-	void ExecuteCommands(std::vector<std::string>);
+	void ExecuteCommands(const std::vector<std::string>&);
 
 	/**
-	 * Intent : 讀取並執行指令檔
+	 * Intent : 以固定大小的區塊串流讀取指令檔，每讀到完整的一行就直接執行，記憶體用量與檔案大小無關
 	 * Pre :
 	 * Post :
 	 * \param filename 指令檔檔名
+	 * \return 是否成功開啟指令檔
+	 */
+	bool ExecuteCommandFile(std::string);
+
+	/**
+	 * Intent : 執行一個二進位指令，回應以二進位格式寫到輸出 (與ExecuteCommand執行相同的指令)
+	 * Pre :
+	 * Post :
+	 * \param request 指令
+	 * \param path 接在frame之後的檔名 (Load BoardFile、Save使用，長度為request.count)
+	 * \return 是否執行成功
+	 */
+	bool ExecuteBinaryCommand(const BinaryRequest&, const char*);
+
+	/**
+	 * Intent : 從stream讀取二進位指令並依序執行，直到stream結束、Quit或遇到不合法的frame
+	 * Pre : stream為binary模式
+	 * Post :
+	 * \param input 輸入的stream
 	 */
-	void ExecuteCommandFile(std::string);
+	void ExecuteBinaryStream(std::istream&);
+
+	/**
+	 * Intent : 回應一個無法執行的frame : status為0、opcode為INVALID，payload為錯誤說明
+	 * Pre : status為INVALID或INCOMPLETE
+	 * Post : 回應寫到輸出，不計入已執行的指令數量
+	 * \param status 解析frame的結果
+	 */
+	void RejectBinaryFrame(BinaryFrameStatus);
 
 	/**
 	 * Intent : 將GameBoard用char組成的二維陣列輸出
@@ -143,8 +203,207 @@ public:
 	 */
 	int GetRemainBlankCount();
 
+	/**
+	 * Intent : 設定盤面整盤運算 (Refresh、UncoverAll、隨機產生) 最多使用的執行緒數量
+	 * Pre :
+	 * Post : 設定完成
+	 * \param threadCount 執行緒數量
+	 */
+	void SetThreadCount(int);
+
+	/**
+	 * Intent : 設定是否啟用第一次點擊安全模式 (隨機盤面的第一次LeftClick必定開出0)
+	 * Pre :
+	 * Post : 設定完成，下一次StartGame後生效
+	 * \param enable 是否啟用
+	 */
+	void SetFirstClickSafe(bool);
+
+	/**
+	 * Intent : 設定LeftClick開啟區域時使用的flood fill實作方式
+	 * Pre :
+	 * Post : 設定完成
+	 * \param mode flood fill的實作方式
+	 */
+	void SetFloodFillMode(FloodFillMode);
+
+	/**
+	 * Intent : 設定Quit指令是否結束整個程式，關閉時Quit只結束這個遊戲 (批次執行、多個遊戲共用一個程式時使用)
+	 * Pre :
+	 * Post : 設定完成
+	 * \param enable 是否結束整個程式
+	 */
+	void SetExitOnQuit(bool);
+
+	/**
+	 * Intent : 設定Print GameBoard/GameAnswer最多印出的格子數，範圍超過時不印出 (伺服器限制一個回應的大小時使用)
+	 * Pre :
+	 * Post : 設定完成
+	 * \param limit 格子數上限
+	 */
+	void SetPrintCellLimit(long long);
+
+	/**
+	 * Intent : 是否已經成功執行過Quit指令 (只在Quit不結束整個程式時有意義)
+	 * Pre :
+	 * Post :
+	 * \return 是否已經執行過Quit
+	 */
+	bool IsQuit();
+
+	/**
+	 * Intent : 回傳已執行的指令數量 (不含空白行)
+	 * Pre :
+	 * Post :
+	 * \return 已執行的指令數量
+	 */
+	long long GetCommandCount();
+
+	/**
+	 * Intent : 回到剛建立時的狀態並改用新的輸出 (SessionPoolCore重複使用實例時呼叫)，盤面記憶體保留重複使用
+	 * Pre :
+	 * Post : Standby狀態，設定回到預設值，未寫出的輸出直接捨棄
+	 * \param outputWriter 新的輸出callback
+	 */
+	void Reset(OutputSinkCore::Writer);
+
+	/**
+	 * Intent : 回傳盤面、flood fill與輸出的buffer保留的記憶體大小 (含未使用的容量)
+	 * Pre :
+	 * Post :
+	 * \return 保留的byte數
+	 */
+	size_t GetRetainedMemorySize() const;
+
+	//Reset後每個盤面與buffer最多保留的記憶體 (byte，含flood fill等輔助buffer)，超過時釋放，閒置的實例不會一直佔著大盤面的記憶體
+	static const size_t RESET_RETAIN_BYTES = 1 << 22;
+
 private:
 
+	/**
+	 * Intent : 依指令種類執行指令
+	 * Pre :
+	 * Post :
+	 * \param action 指令的第一個token
+	 * \param tokens 指令剩下的token
+	 * \return 執行結果
+	 */
+	CommandResult DispatchCommand(const CommandToken&, CommandTokenizerCore&);
+
+	/**
+	 * Intent : 執行Load指令
+	 * Pre :
+	 * Post : 成功時盤面載入完成
+	 * \param tokens 指令剩下的token (載入模式與參數)
+	 * \return 執行結果
+	 */
+	CommandResult ExecuteLoad(CommandTokenizerCore&);
+
+	/**
+	 * Intent : 執行Set指令
+	 * Pre :
+	 * Post : 成功時設定完成
+	 * \param tokens 指令剩下的token (選項名稱與值)
+	 * \return 執行結果
+	 */
+	CommandResult ExecuteSet(CommandTokenizerCore&);
+
+	/**
+	 * Intent : 檢查是否可以載入盤面，並清除已載入的盤面
+	 * Pre :
+	 * Post : 成功時兩種盤面都已清除
+	 * \return 是否可以載入 (Standby狀態)
+	 */
+	bool PrepareLoad();
+
+	/**
+	 * Intent : 執行StartGame指令
+	 * Pre :
+	 * Post : 成功時進入Playing狀態
+	 * \return 執行結果
+	 */
+	CommandResult ExecuteStartGame();
+
+	/**
+	 * Intent : 執行LeftClick指令
+	 * Pre :
+	 * Post : 成功時開啟格子，可能導致遊戲結束
+	 * \param row row位置
+	 * \param col col位置
+	 * \return 執行結果
+	 */
+	CommandResult ExecuteLeftClick(long long, long long);
+
+	/**
+	 * Intent : 執行RightClick指令
+	 * Pre :
+	 * Post : 成功時標註格子
+	 * \param row row位置
+	 * \param col col位置
+	 * \return 執行結果
+	 */
+	CommandResult ExecuteRightClick(long long, long long);
+
+	/**
+	 * Intent : 執行Replay指令
+	 * Pre :
+	 * Post : 成功時回到Standby狀態
+	 * \return 執行結果
+	 */
+	CommandResult ExecuteReplay();
+
+	/**
+	 * Intent : 執行Save BoardFile指令，把目前的盤面寫成二進位盤面檔 (含數字平面與種子)
+	 * Pre :
+	 * Post : 成功時盤面檔寫入完成
+	 * \param filename 盤面檔檔名
+	 * \return 執行結果
+	 */
+	CommandResult ExecuteSave(const std::string&);
+
+	/**
+	 * Intent : 執行Quit指令
+	 * Pre :
+	 * Post : 成功時標記為已Quit，由呼叫端在回應寫出後決定是否結束整個程式
+	 * \return 執行結果
+	 */
+	CommandResult ExecuteQuit();
+
+	/**
+	 * Intent : 寫出緩衝區並結束整個程式 (Quit且exitOnQuit時)
+	 * Pre : 回應已寫入緩衝區
+	 * Post : 程式結束
+	 */
+	void ExitProgram();
+
+	/**
+	 * Intent : 執行二進位的Load指令
+	 * Pre :
+	 * Post : 成功時盤面載入完成
+	 * \param request 指令 (option為盤面種類)
+	 * \param path 盤面檔檔名 (長度為request.count)
+	 * \return 執行結果
+	 */
+	CommandResult ExecuteBinaryLoad(const BinaryRequest&, const char*);
+
+	/**
+	 * Intent : 執行二進位的Set指令
+	 * Pre :
+	 * Post : 成功時設定完成
+	 * \param request 指令 (option為選項，count為值)
+	 * \return 執行結果
+	 */
+	CommandResult ExecuteBinarySet(const BinaryRequest&);
+
+	/**
+	 * Intent : 寫出二進位回應 : header、變更格子的位置、變更格子的字元、Print內容
+	 * Pre : changeLog與payloadBuffer為這個指令的結果
+	 * Post :
+	 * \param opcode 指令種類
+	 * \param success 是否執行成功
+	 */
+	void WriteBinaryResponse(BinaryOpcode, bool);
+
 	/**
 	 * Intent : 重新設定row col的數量
 	 * Pre : 並非處於Playing狀態中
@@ -155,24 +414,13 @@ private:
 	void ResetRowCol(int, int);
 
 	/**
-	 * Intent : 動態配置記憶體，產生bomb map (2維bool陣列)
+	 * Intent : 讀取Load指令最後的隨機種子參數，沒有指定時產生一個新的種子
 	 * Pre :
-	 * Post : 記憶體配置完成
-	 * \param rows row數量
-	 * \param cols col數量
-	 * \return bomb map陣列指標
-	 */
-	bool** NewBombMap(int rows, int cols);
-
-
-	/**
-	 * Intent : 釋放bomb map的記憶體
-	 * Pre : 記憶體配置完成
-	 * Post : 釋放完成
-	 * \param isBombMap bomb map陣列指標
-	 * \param rows row數量
+	 * Post :
+	 * \param tokens 指令剩下的token
+	 * \return 隨機種子
 	 */
-	void DelBombMap(bool**, int);
+	std::uint64_t ReadSeed(CommandTokenizerCore&);
 
 	/**
 	 * Intent :	清除資訊
@@ -198,10 +446,10 @@ private:
 	/**
 	 * Intent : 用盤面檔模式來載入
 	 * Pre :
-	 * Post : 載入完成
+	 * Post : 載入完成，文字盤面檔格式錯誤時錯誤說明記錄在loadError
 	 * \param filename 盤面檔檔名
 	 */
-	void LoadFileBoard(std::string filename);
+	void LoadFileBoard(const std::string& filename);
 
 	/**
 	 * Intent :	用RandomCount模式來載入
@@ -210,8 +458,9 @@ private:
 	 * \param _rows row數量
 	 * \param _cols col數量
 	 * \param bombCount 指令炸彈數量
+	 * \param seed 隨機種子
 	 */
-	void LoadRandomCountBoard(int rows, int cols, int bombCount);
+	void LoadRandomCountBoard(int rows, int cols, int bombCount, std::uint64_t seed);
 
 	/**
 	 * Intent :	用RandomRate模式來載入
@@ -220,8 +469,36 @@ private:
 	 * \param _rows row數量
 	 * \param _cols col數量
 	 * \param bombRate 炸彈生成機率
+	 * \param seed 隨機種子
 	 */
-	void LoadRandomRateBoard(int rows, int cols, float bombRate);
+	void LoadRandomRateBoard(int rows, int cols, float bombRate, std::uint64_t seed);
+
+	/**
+	 * Intent :	用沒有邊界的區塊盤面來載入，區塊在第一次被存取時才產生
+	 * Pre :
+	 * Post : 載入完成
+	 * \param bombRate 炸彈生成機率
+	 * \param seed 隨機種子
+	 */
+	void LoadInfiniteBoard(float bombRate, std::uint64_t seed);
+
+	/**
+	 * Intent : 目前的盤面是否已載入 (依載入模式選擇BoardCore或ChunkBoardCore)
+	 * Pre :
+	 * Post :
+	 * \return 目前的盤面是否已載入
+	 */
+	bool IsBoardLoaded();
+
+	/**
+	 * Intent : 獲取目前盤面上該格的指標 (依載入模式選擇BoardCore或ChunkBoardCore)
+	 * Pre : row col合法
+	 * Post :
+	 * \param row row位置
+	 * \param col col位置
+	 * \return 該格的指標
+	 */
+	CellCore* GetBoardCell(long long, long long);
 
 	/**
 	 * Intent : 盤面是否存在 (是否已經執行Load指令了)
@@ -235,9 +512,15 @@ private:
 	 * Intent : 執行print指令
 	 * Pre :
 	 * Post :
-	 * \param printTarget 要印出的資訊名稱
+	 * \param sink 輸出的緩衝區 (文字指令為output，二進位指令為payload)
+	 * \param target 要印出的資訊
+	 * \param hasRange 是否有指定範圍 (只有沒有邊界的盤面使用)
+	 * \param top 範圍的左上角row
+	 * \param left 範圍的左上角col
+	 * \param rowCount 範圍的row數量
+	 * \param colCount 範圍的col數量
 	 */
-	void ExecutePrint(std::string);
+	void ExecutePrint(OutputSinkCore&, BinaryPrintTarget, bool, long long, long long, long long, long long);
 
 	/**
 	 * Intent : 左鍵開啟格子
@@ -246,7 +529,7 @@ private:
 	 * \param row row位置
 	 * \param col col位置
 	 */
-	void LeftClick(int, int);
+	void LeftClick(long long, long long);
 
 	/**
 	 * Intent : 右鍵標註格子
@@ -255,7 +538,7 @@ private:
 	 * \param row row位置
 	 * \param col col位置
 	 */
-	void RightClick(int, int);
+	void RightClick(long long, long long);
 
 	/**
 	 * Intent :	遊戲是否結束 (玩家是否贏得遊戲)
@@ -287,7 +570,7 @@ private:
 	 * \param col 輸入的col
 	 * \return 輸入的row col是否合法
 	 */
-	bool ValidRowCol(int, int);
+	bool ValidRowCol(long long, long long);
 
 	//row的數量
 	int rows = 9;
@@ -298,11 +581,53 @@ private:
 	//盤面處理api
 	BoardCore* gameBoard = nullptr;
 
+	//沒有邊界的盤面處理api (Load Infinite時使用)
+	ChunkBoardCore* chunkBoard = nullptr;
+
+	//指令回應的輸出緩衝區 (每個實例各自擁有)
+	OutputSinkCore output;
+
 	//遊戲狀態
 	MineSweeperState gameState = MineSweeperState::STANDBY;
 
 	//儲存玩家輸或贏，遊戲結束後才會存取到
 	bool playerWin = false;
+
+	//最近一次隨機盤面使用的種子
+	std::uint64_t boardSeed = 0;
+
+	//目前盤面的載入模式
+	BoardCoreGenerateType boardType = BoardCoreGenerateType::FILE;
+
+	//是否啟用第一次點擊安全模式
+	bool firstClickSafe = false;
+
+	//StartGame後是否還沒有執行過LeftClick
+	bool firstClickPending = false;
+
+	//Quit是否結束整個程式，以及是否已經執行過Quit
+	bool exitOnQuit = true;
+	bool quitRequested = false;
+
+	//已執行的指令數量
+	long long commandCount = 0;
+
+	//Print GameBoard/GameAnswer最多印出的格子數 (沒有邊界的盤面同時受ChunkBoardCore::PRINT_MAX_CELLS限制)
+	long long printCellLimit = LLONG_MAX;
+
+	//是否以文字回應 (執行二進位指令時不印出Success、遊戲結果等文字)
+	bool textResponse = true;
+
+	//Load BoardFile的檔名，重複使用，載入時不需要每次配置字串
+	std::string boardPath;
+
+	//盤面檔格式錯誤的說明 (檔名與錯誤位置)，由該指令的回應印出後清除
+	std::string loadError;
+
+	//二進位指令 : 點擊改變的格子，以及Print的內容 (重複使用)
+	std::vector<CellChange> changeLog;
+	std::vector<char> payloadBuffer;
+	OutputSinkCore payloadSink;
 };
 
 #endif // !_MINESWEEPERCORE_H_
\ No newline at end of file
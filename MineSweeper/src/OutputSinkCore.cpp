@@ -0,0 +1,239 @@
+﻿/*****************************************************************//**
+ * File : OutputSinkCore.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api implementation of MineSweeperExample
+ *********************************************************************/
+
+#include "OutputSinkCore.h"
+
+#include <algorithm>
+
+using namespace std;
+
+//OutputSinkCore constructor，輸出到stream
+OutputSinkCore::OutputSinkCore(std::ostream& _stream) : stream(&_stream)
+{
+
+}
+
+//OutputSinkCore constructor，輸出交給callback (socket、file descriptor、記憶體等)
+OutputSinkCore::OutputSinkCore(Writer _writer) : writer(_writer)
+{
+
+}
+
+//OutputSinkCore destructor
+OutputSinkCore::~OutputSinkCore()
+{
+	if (used > 0)
+	{
+		Flush();
+	}
+}
+
+//寫入字元
+OutputSinkCore& OutputSinkCore::operator<<(char value)
+{
+	*Reserve(1) = value;
+	Commit(1);
+	return *this;
+}
+
+//寫入字串
+OutputSinkCore& OutputSinkCore::operator<<(const char* value)
+{
+	Write(value, strlen(value));
+	return *this;
+}
+
+//寫入字串
+OutputSinkCore& OutputSinkCore::operator<<(const std::string& value)
+{
+	Write(value.data(), value.size());
+	return *this;
+}
+
+/**
+ * Intent : 寫入一段byte
+ * Pre :
+ * Post :
+ * \param data 資料
+ * \param size 資料大小
+ */
+void OutputSinkCore::Write(const char* data, size_t size)
+{
+	memcpy(Reserve(size), data, size);
+	Commit(size);
+}
+
+/**
+ * Intent : 預留一段可以直接寫入的空間，buffer已累積超過FLUSH_THRESHOLD時先flush
+ * Pre :
+ * Post : 回傳的指標在Commit前有效
+ * \param size 需要的空間大小
+ * \return 可以寫入的位置
+ */
+char* OutputSinkCore::Reserve(size_t size)
+{
+	//一次很大的輸出 (整個盤面) 在累積到一定大小時分段寫出，buffer不會跟著輸出一起變大
+	if (used >= FLUSH_THRESHOLD)
+	{
+		Flush();
+	}
+	if (used + size > buffer.size())
+	{
+		buffer.resize(max(used + size, max(buffer.size() * 2, (size_t)4096)));
+	}
+	return buffer.data() + used;
+}
+
+/**
+ * Intent : 確認Reserve後實際寫入的大小
+ * Pre : size不超過Reserve的大小
+ * Post :
+ * \param size 實際寫入的大小
+ */
+void OutputSinkCore::Commit(size_t size)
+{
+	used += size;
+}
+
+/**
+ * Intent : 一個回應結束 (flush point)，自動flush模式或buffer超過FLUSH_THRESHOLD時flush
+ * Pre :
+ * Post :
+ */
+void OutputSinkCore::EndResponse()
+{
+	if (autoFlush || used >= FLUSH_THRESHOLD)
+	{
+		Flush();
+	}
+}
+
+/**
+ * Intent : 把buffer的內容寫到輸出目標 (stream時同時flush stream)
+ * Pre :
+ * Post : buffer清空
+ */
+void OutputSinkCore::Flush()
+{
+	if (stream == nullptr)
+	{
+		if (used > 0 && writer)
+		{
+			writer(buffer.data(), used);
+		}
+		used = 0;
+		return;
+	}
+
+	if (used > 0)
+	{
+		stream->write(buffer.data(), used);
+		used = 0;
+	}
+	stream->flush();
+}
+
+/**
+ * Intent : 改用新的callback輸出，未寫出的資料直接捨棄，buffer保留重複使用
+ * Pre :
+ * Post : 回到自動flush模式
+ * \param _writer 新的callback
+ */
+void OutputSinkCore::Reset(Writer _writer)
+{
+	stream = nullptr;
+	writer = _writer;
+	used = 0;
+	autoFlush = true;
+}
+
+/**
+ * Intent : 釋放buffer的記憶體
+ * Pre : buffer已寫出 (Flush或Reset之後)
+ * Post : buffer保留的記憶體超過maxBytes時釋放
+ * \param maxBytes 可以保留的記憶體上限 (byte)
+ */
+void OutputSinkCore::ShrinkMem(size_t maxBytes)
+{
+	if (used == 0 && buffer.capacity() > maxBytes)
+	{
+		vector<char>().swap(buffer);
+	}
+}
+
+/**
+ * Intent : 回傳buffer保留的記憶體大小
+ * Pre :
+ * Post :
+ * \return 保留的byte數
+ */
+size_t OutputSinkCore::GetRetainedMemorySize() const
+{
+	return buffer.capacity();
+}
+
+/**
+ * Intent : 設定是否每個回應結束就flush
+ * Pre :
+ * Post : 設定完成
+ * \param enable 是否啟用
+ */
+void OutputSinkCore::SetAutoFlush(bool enable)
+{
+	autoFlush = enable;
+}
+
+/**
+ * Intent : 回傳是否每個回應結束就flush
+ * Pre :
+ * Post :
+ * \return 是否啟用
+ */
+bool OutputSinkCore::GetAutoFlush()
+{
+	return autoFlush;
+}
+
+/**
+ * Intent : 寫入有號整數
+ * Pre :
+ * Post :
+ * \param value 數值
+ */
+void OutputSinkCore::WriteSigned(long long value)
+{
+	if (value < 0)
+	{
+		*this << '-';
+		WriteUnsigned(0 - (unsigned long long)value);
+	}
+	else
+	{
+		WriteUnsigned((unsigned long long)value);
+	}
+}
+
+/**
+ * Intent : 寫入無號整數
+ * Pre :
+ * Post :
+ * \param value 數值
+ */
+void OutputSinkCore::WriteUnsigned(unsigned long long value)
+{
+	//由低位往高位填入，最多20位數
+	char digits[20];
+	int count = 0;
+	do
+	{
+		digits[sizeof(digits) - 1 - count++] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value != 0);
+	Write(digits + sizeof(digits) - count, count);
+}
@@ -0,0 +1,178 @@
+﻿/*****************************************************************//**
+ * File : OutputSinkCore.h
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api header of MineSweeperExample
+ *********************************************************************/
+
+#pragma once
+#ifndef _OUTPUTSINKCORE_H_
+#define _OUTPUTSINKCORE_H_
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+//指令輸出的緩衝區，回應先寫進重複使用的buffer，在flush時才一次寫到目標 (stream或callback)
+//自動flush模式下每個回應結束就flush (互動模式、GUI)，否則累積到FLUSH_THRESHOLD才整塊寫出 (指令檔模式)
+//每個MineSweeperCore各自擁有一個，不同執行緒上的遊戲不會共用輸出
+class OutputSinkCore
+{
+public:
+
+	//flush時接收整塊輸出的callback，參數為 (資料, 資料大小)
+	typedef std::function<void(const char*, size_t)> Writer;
+
+	//OutputSinkCore constructor，輸出到stream
+	OutputSinkCore(std::ostream&);
+
+	//OutputSinkCore constructor，輸出交給callback (socket、file descriptor、記憶體等)
+	OutputSinkCore(Writer);
+
+	//OutputSinkCore destructor
+	~OutputSinkCore();
+
+	//緩衝區綁定輸出目標，不能複製
+	OutputSinkCore(const OutputSinkCore&) = delete;
+	OutputSinkCore& operator=(const OutputSinkCore&) = delete;
+
+	//寫入字元、字串
+	OutputSinkCore& operator<<(char);
+	OutputSinkCore& operator<<(const char*);
+	OutputSinkCore& operator<<(const std::string&);
+
+	//寫入整數 (十進位)
+	template <typename T>
+	typename std::enable_if<std::is_integral<T>::value, OutputSinkCore&>::type operator<<(T value)
+	{
+		if (std::is_signed<T>::value)
+		{
+			WriteSigned((long long)value);
+		}
+		else
+		{
+			WriteUnsigned((unsigned long long)value);
+		}
+		return *this;
+	}
+
+	/**
+	 * Intent : 寫入一段byte
+	 * Pre :
+	 * Post :
+	 * \param data 資料
+	 * \param size 資料大小
+	 */
+	void Write(const char*, size_t);
+
+	/**
+	 * Intent : 預留一段可以直接寫入的空間，buffer已累積超過FLUSH_THRESHOLD時先flush
+	 * Pre :
+	 * Post : 回傳的指標在Commit前有效
+	 * \param size 需要的空間大小
+	 * \return 可以寫入的位置
+	 */
+	char* Reserve(size_t);
+
+	/**
+	 * Intent : 確認Reserve後實際寫入的大小
+	 * Pre : size不超過Reserve的大小
+	 * Post :
+	 * \param size 實際寫入的大小
+	 */
+	void Commit(size_t);
+
+	/**
+	 * Intent : 一個回應結束 (flush point)，自動flush模式或buffer超過FLUSH_THRESHOLD時flush
+	 * Pre :
+	 * Post :
+	 */
+	void EndResponse();
+
+	/**
+	 * Intent : 把buffer的內容寫到輸出目標 (stream時同時flush stream)
+	 * Pre :
+	 * Post : buffer清空
+	 */
+	void Flush();
+
+	/**
+	 * Intent : 改用新的callback輸出，未寫出的資料直接捨棄，buffer保留重複使用
+	 * Pre :
+	 * Post : 回到自動flush模式
+	 * \param writer 新的callback
+	 */
+	void Reset(Writer);
+
+	/**
+	 * Intent : 釋放buffer的記憶體
+	 * Pre : buffer已寫出 (Flush或Reset之後)
+	 * Post : buffer保留的記憶體超過maxBytes時釋放
+	 * \param maxBytes 可以保留的記憶體上限 (byte)
+	 */
+	void ShrinkMem(size_t);
+
+	/**
+	 * Intent : 回傳buffer保留的記憶體大小
+	 * Pre :
+	 * Post :
+	 * \return 保留的byte數
+	 */
+	size_t GetRetainedMemorySize() const;
+
+	/**
+	 * Intent : 設定是否每個回應結束就flush
+	 * Pre :
+	 * Post : 設定完成
+	 * \param enable 是否啟用
+	 */
+	void SetAutoFlush(bool);
+
+	/**
+	 * Intent : 回傳是否每個回應結束就flush
+	 * Pre :
+	 * Post :
+	 * \return 是否啟用
+	 */
+	bool GetAutoFlush();
+
+	//非自動flush模式下，buffer累積到這個大小才寫出
+	static const size_t FLUSH_THRESHOLD = 1 << 20;
+
+private:
+
+	/**
+	 * Intent : 寫入有號整數
+	 * Pre :
+	 * Post :
+	 * \param value 數值
+	 */
+	void WriteSigned(long long);
+
+	/**
+	 * Intent : 寫入無號整數
+	 * Pre :
+	 * Post :
+	 * \param value 數值
+	 */
+	void WriteUnsigned(unsigned long long);
+
+	//輸出的目標，stream為nullptr時使用writer
+	std::ostream* stream = nullptr;
+	Writer writer;
+
+	//重複使用的buffer與已使用的大小
+	std::vector<char> buffer;
+	size_t used = 0;
+
+	//是否每個回應結束就flush
+	bool autoFlush = true;
+};
+
+#endif // !_OUTPUTSINKCORE_H_
@@ -0,0 +1,135 @@
+﻿/*****************************************************************//**
+ * File : RandomCore.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api implementation of MineSweeperExample
+ *********************************************************************/
+
+#include "RandomCore.h"
+
+using namespace std;
+
+//RandomCore constructor
+RandomCore::RandomCore(std::uint64_t seed, std::uint64_t stream)
+{
+	key = Mix(seed ^ Mix(stream + GOLDEN_GAMMA));
+}
+
+/**
+ * Intent : 產生下一個64bit隨機數
+ * Pre :
+ * Post : counter加1
+ * \return 64bit隨機數
+ */
+std::uint64_t RandomCore::Next()
+{
+	counter++;
+	return Mix(key + counter * GOLDEN_GAMMA);
+}
+
+/**
+ * Intent : 產生 (0, 1] 之間的隨機浮點數 (53bit精度)
+ * Pre :
+ * Post :
+ * \return (0, 1] 之間的隨機浮點數
+ */
+double RandomCore::NextOpenDouble()
+{
+	return (double)((Next() >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Intent : 產生 [0, bound) 之間均勻分佈的隨機整數 (拒絕取樣，沒有模數偏差)
+ * Pre : bound > 0
+ * Post :
+ * \param bound 上限 (不含)
+ * \return [0, bound) 之間的隨機整數
+ */
+std::uint64_t RandomCore::NextBelow(std::uint64_t bound)
+{
+	//小於threshold的值會造成偏差，丟掉重抽 (機率小於 bound / 2^64)
+	std::uint64_t threshold = (0 - bound) % bound;
+	while (true)
+	{
+		std::uint64_t value = Next();
+		if (value >= threshold)
+		{
+			return value % bound;
+		}
+	}
+}
+
+/**
+ * Intent : 產生幾何分佈的跳躍距離 (每格以機率p被選中時，下一個被選中的格子前要跳過幾格)
+ * Pre : keepPowers由BuildKeepPowers建立
+ * Post :
+ * \param keepPowers (1-p)^(2^m) 的表
+ * \param powerCount 表的長度
+ * \return 要跳過的格子數
+ */
+std::uint64_t RandomCore::NextGeometricSkip(const double* keepPowers, int powerCount)
+{
+	//跳過k格的機率為 (1-p)^k * p，等價於找出滿足 U <= (1-p)^k 的最大k
+	//用二進位逐位決定k，只需要乘法與比較，避免log在不同平台上的誤差造成盤面不同
+	double u = NextOpenDouble();
+	double value = 1.0;
+	std::uint64_t skip = 0;
+	for (int m = powerCount - 1; m >= 0; m--)
+	{
+		double next = value * keepPowers[m];
+		if (next >= u)
+		{
+			value = next;
+			skip += (std::uint64_t)1 << m;
+		}
+	}
+	return skip;
+}
+
+/**
+ * Intent : 建立 (1-p)^(2^m) 的表，只用乘法計算，在所有IEEE 754平台上結果都相同
+ * Pre : 0 < p < 1，keepPowers至少可以放64個元素
+ * Post :
+ * \param keep 1-p
+ * \param keepPowers 輸出的表
+ * \return 表的長度 (之後的次方都已經是0)
+ */
+int RandomCore::BuildKeepPowers(double keep, double* keepPowers)
+{
+	int count = 0;
+	double power = keep;
+	while (count < 63 && power > 0.0)
+	{
+		keepPowers[count++] = power;
+		power = power * power;
+	}
+	return count;
+}
+
+/**
+ * Intent : splitmix64的混合函數
+ * Pre :
+ * Post :
+ * \param value 輸入值
+ * \return 混合後的值
+ */
+std::uint64_t RandomCore::Mix(std::uint64_t value)
+{
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	return value ^ (value >> 31);
+}
+
+/**
+ * Intent : 從std::random_device取得一個新的64bit種子
+ * Pre :
+ * Post :
+ * \return 64bit種子
+ */
+std::uint64_t RandomCore::RandomSeed()
+{
+	std::random_device rd;
+	return ((std::uint64_t)rd() << 32) ^ rd();
+}
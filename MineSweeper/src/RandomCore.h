@@ -0,0 +1,101 @@
+﻿/*****************************************************************//**
+ * File : RandomCore.h
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api header of MineSweeperExample
+ *********************************************************************/
+
+#pragma once
+#ifndef _RANDOMCORE_H_
+#define _RANDOMCORE_H_
+
+#include <cstdint>
+#include <random>
+
+//counter-based的隨機數產生器 (splitmix64)
+//第i個隨機數只由 (seed, stream, i) 決定，不同stream之間互相獨立，
+//因此可以把盤面切成多個block平行產生，且結果與執行緒數量、平台無關
+class RandomCore
+{
+public:
+
+	//RandomCore constructor
+	RandomCore(std::uint64_t, std::uint64_t);
+
+	/**
+	 * Intent : 產生下一個64bit隨機數
+	 * Pre :
+	 * Post : counter加1
+	 * \return 64bit隨機數
+	 */
+	std::uint64_t Next();
+
+	/**
+	 * Intent : 產生 (0, 1] 之間的隨機浮點數 (53bit精度)
+	 * Pre :
+	 * Post :
+	 * \return (0, 1] 之間的隨機浮點數
+	 */
+	double NextOpenDouble();
+
+	/**
+	 * Intent : 產生 [0, bound) 之間均勻分佈的隨機整數 (拒絕取樣，沒有模數偏差)
+	 * Pre : bound > 0
+	 * Post :
+	 * \param bound 上限 (不含)
+	 * \return [0, bound) 之間的隨機整數
+	 */
+	std::uint64_t NextBelow(std::uint64_t);
+
+	/**
+	 * Intent : 產生幾何分佈的跳躍距離 (每格以機率p被選中時，下一個被選中的格子前要跳過幾格)
+	 * Pre : keepPowers由BuildKeepPowers建立
+	 * Post :
+	 * \param keepPowers (1-p)^(2^m) 的表
+	 * \param powerCount 表的長度
+	 * \return 要跳過的格子數
+	 */
+	std::uint64_t NextGeometricSkip(const double*, int);
+
+	/**
+	 * Intent : 建立 (1-p)^(2^m) 的表，只用乘法計算，在所有IEEE 754平台上結果都相同
+	 * Pre : 0 < p < 1，keepPowers至少可以放64個元素
+	 * Post :
+	 * \param keep 1-p
+	 * \param keepPowers 輸出的表
+	 * \return 表的長度 (之後的次方都已經是0)
+	 */
+	static int BuildKeepPowers(double, double*);
+
+	/**
+	 * Intent : splitmix64的混合函數
+	 * Pre :
+	 * Post :
+	 * \param value 輸入值
+	 * \return 混合後的值
+	 */
+	static std::uint64_t Mix(std::uint64_t);
+
+	/**
+	 * Intent : 從std::random_device取得一個新的64bit種子
+	 * Pre :
+	 * Post :
+	 * \return 64bit種子
+	 */
+	static std::uint64_t RandomSeed();
+
+private:
+
+	//由 (seed, stream) 決定的key
+	std::uint64_t key = 0;
+
+	//目前產生到第幾個隨機數
+	std::uint64_t counter = 0;
+
+	//splitmix64的遞增常數 (黃金比例)
+	static const std::uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+};
+
+#endif // !_RANDOMCORE_H_
@@ -0,0 +1,722 @@
+﻿/*****************************************************************//**
+ * File : ServerCore.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api implementation of MineSweeperExample
+ *********************************************************************/
+
+#include "ServerCore.h"
+#include "BinaryProtocolCore.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+
+#ifdef __linux__
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef __linux__
+//signal handler用來喚醒epoll的eventfd (同時只有一個伺服器在執行)
+static volatile sig_atomic_t signalWakeFd = -1;
+
+//SIGINT/SIGTERM : 喚醒epoll讓伺服器結束
+static void HandleStopSignal(int)
+{
+	int fd = signalWakeFd;
+	if (fd >= 0)
+	{
+		uint64_t one = 1;
+		ssize_t written = write(fd, &one, sizeof(one));
+		(void)written;
+	}
+}
+#endif
+
+//ServerCore constructor
+ServerCore::ServerCore(std::string _socketPath) : socketPath(_socketPath)
+{
+
+}
+
+//ServerCore destructor
+ServerCore::~ServerCore()
+{
+	Close();
+}
+
+//Session constructor，由pool取得遊戲，遊戲的回應直接附加到output
+ServerCore::Session::Session(int _fd) : fd(_fd), game(SessionPoolCore::Instance().Acquire([this](const char* data, size_t size)
+{
+	output.insert(output.end(), data, data + size);
+	producedTotal += (long long)size;
+}))
+{
+	//Quit只結束這個連線的遊戲，盤面太大時不印出，一個回應的大小有上限
+	game->SetExitOnQuit(false);
+	game->SetPrintCellLimit(PRINT_CELL_LIMIT);
+}
+
+//Session destructor，遊戲歸還給pool
+ServerCore::Session::~Session()
+{
+	SessionPoolCore::Instance().Release(move(game));
+}
+
+/**
+ * Intent : 開始監聽socket並處理連線，直到收到SIGINT/SIGTERM或Stop
+ * Pre :
+ * Post : 所有連線關閉、socket檔案移除，統計結果印到report
+ * \param report 印出狀態與統計結果的stream
+ * \return 是否成功啟動
+ */
+bool ServerCore::Run(std::ostream& report)
+{
+#ifndef __linux__
+	report << "Server mode requires Linux (epoll and Unix domain sockets)" << endl;
+	return false;
+#else
+	if (!Open(report))
+	{
+		Close();
+		return false;
+	}
+
+	//收到SIGINT/SIGTERM時結束，送出回應時對方已關閉的錯誤由send回傳，不需要SIGPIPE
+	struct sigaction stopAction, oldIntAction, oldTermAction, oldPipeAction;
+	memset(&stopAction, 0, sizeof(stopAction));
+	stopAction.sa_handler = HandleStopSignal;
+	sigemptyset(&stopAction.sa_mask);
+	signalWakeFd = wakeFd;
+	sigaction(SIGINT, &stopAction, &oldIntAction);
+	sigaction(SIGTERM, &stopAction, &oldTermAction);
+	stopAction.sa_handler = SIG_IGN;
+	sigaction(SIGPIPE, &stopAction, &oldPipeAction);
+
+	report << "Listening : " << socketPath << endl;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	vector<epoll_event> events(256);
+	bool running = true;
+
+	while (running)
+	{
+		//暫停監聽時定時醒來重新嘗試，file descriptor可能被其他process釋放
+		int eventCount = epoll_wait(epollFd, events.data(), (int)events.size(), acceptPaused ? ACCEPT_RETRY_MS : -1);
+		if (eventCount < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			report << "epoll_wait failed : " << strerror(errno) << endl;
+			break;
+		}
+		if (eventCount == 0 && acceptPaused)
+		{
+			SetAcceptEnabled(true);
+		}
+
+		for (int i = 0; i < eventCount; i++)
+		{
+			int fd = events[i].data.fd;
+			if (fd == listenFd)
+			{
+				AcceptSessions();
+			}
+			else if (fd == wakeFd)
+			{
+				running = false;
+			}
+			else if (fd < (int)sessions.size() && sessions[fd])
+			{
+				HandleSession(*sessions[fd], events[i].events);
+			}
+		}
+	}
+
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	signalWakeFd = -1;
+	sigaction(SIGINT, &oldIntAction, nullptr);
+	sigaction(SIGTERM, &oldTermAction, nullptr);
+	sigaction(SIGPIPE, &oldPipeAction, nullptr);
+
+	long long activeAtShutdown = activeCount;
+	Close();
+	report << "Active sessions at shutdown : " << activeAtShutdown << endl;
+	Report(report, seconds);
+	return true;
+#endif
+}
+
+/**
+ * Intent : 要求伺服器結束 (可以從其他執行緒呼叫)
+ * Pre :
+ * Post : Run在處理完目前的事件後返回
+ */
+void ServerCore::Stop()
+{
+#ifdef __linux__
+	if (wakeFd >= 0)
+	{
+		uint64_t one = 1;
+		ssize_t written = write(wakeFd, &one, sizeof(one));
+		(void)written;
+	}
+#endif
+}
+
+/**
+ * Intent : 關閉所有連線與file descriptor，移除socket檔案
+ * Pre :
+ * Post :
+ */
+void ServerCore::Close()
+{
+#ifdef __linux__
+	for (size_t i = 0; i < sessions.size(); i++)
+	{
+		if (sessions[i])
+		{
+			CloseSession(*sessions[i], false);
+		}
+	}
+	sessions.clear();
+
+	if (listenFd >= 0)
+	{
+		close(listenFd);
+		listenFd = -1;
+		unlink(socketPath.c_str());
+	}
+	if (epollFd >= 0)
+	{
+		close(epollFd);
+		epollFd = -1;
+	}
+	if (wakeFd >= 0)
+	{
+		close(wakeFd);
+		wakeFd = -1;
+	}
+#endif
+}
+
+#ifdef __linux__
+/**
+ * Intent : 建立監聽socket、epoll與喚醒用的eventfd
+ * Pre :
+ * Post :
+ * \param report 印出錯誤的stream
+ * \return 是否成功
+ */
+bool ServerCore::Open(std::ostream& report)
+{
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path))
+	{
+		report << "Invalid socket path : " << socketPath << endl;
+		return false;
+	}
+	memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+
+	//同時服務大量連線，file descriptor上限調到系統允許的最大值
+	rlimit fileLimit;
+	if (getrlimit(RLIMIT_NOFILE, &fileLimit) == 0 && fileLimit.rlim_cur < fileLimit.rlim_max)
+	{
+		fileLimit.rlim_cur = fileLimit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &fileLimit);
+	}
+
+	//上次沒有正常結束留下的socket檔案才移除，不覆蓋其他檔案
+	struct stat info;
+	if (stat(socketPath.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+	{
+		unlink(socketPath.c_str());
+	}
+
+	listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (listenFd < 0 || bind(listenFd, (sockaddr*)&address, sizeof(address)) != 0)
+	{
+		report << "Cannot bind " << socketPath << " : " << strerror(errno) << endl;
+		if (listenFd >= 0)
+		{
+			close(listenFd);
+			listenFd = -1;
+		}
+		return false;
+	}
+
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (listen(listenFd, SOMAXCONN) != 0 || epollFd < 0 || wakeFd < 0)
+	{
+		report << "Cannot listen on " << socketPath << " : " << strerror(errno) << endl;
+		return false;
+	}
+
+	epoll_event event;
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN;
+	event.data.fd = listenFd;
+	epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+	event.data.fd = wakeFd;
+	epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+	acceptPaused = false;
+	activeCount = openedCount = completedCount = commandCount = 0;
+	latency = LatencyHistogram();
+	return true;
+}
+
+/**
+ * Intent : 接受所有等待中的連線
+ * Pre :
+ * Post :
+ */
+void ServerCore::AcceptSessions()
+{
+	while (true)
+	{
+		int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0)
+		{
+			if (errno == EINTR || errno == ECONNABORTED)
+			{
+				continue;
+			}
+
+			//file descriptor或記憶體用完 : 連線還在等待，監聽socket會一直可讀，暫停監聽直到有連線關閉
+			if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+			{
+				SetAcceptEnabled(false);
+			}
+
+			//EAGAIN代表沒有等待中的連線
+			return;
+		}
+
+		if (fd >= (int)sessions.size())
+		{
+			sessions.resize(max((size_t)fd + 1, sessions.size() * 2));
+		}
+		sessions[fd].reset(new Session(fd));
+		activeCount++;
+		openedCount++;
+		UpdateEvents(*sessions[fd]);
+	}
+}
+
+/**
+ * Intent : 開始或暫停監聽新的連線 (file descriptor用完時暫停，避免epoll一直回報監聽socket可讀)
+ * Pre :
+ * Post :
+ * \param enabled 是否監聽
+ */
+void ServerCore::SetAcceptEnabled(bool enabled)
+{
+	if (acceptPaused != enabled)
+	{
+		return;
+	}
+
+	epoll_event event;
+	memset(&event, 0, sizeof(event));
+	event.events = enabled ? (uint32_t)EPOLLIN : 0;
+	event.data.fd = listenFd;
+	epoll_ctl(epollFd, EPOLL_CTL_MOD, listenFd, &event);
+	acceptPaused = !enabled;
+}
+
+/**
+ * Intent : 處理一個連線的epoll事件 : 讀取、執行指令、送出回應，結束時關閉連線
+ * Pre :
+ * Post :
+ * \param session 連線
+ * \param events epoll事件
+ */
+void ServerCore::HandleSession(Session& session, std::uint32_t events)
+{
+	if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0 && !ReadInput(session))
+	{
+		CloseSession(session, false);
+		return;
+	}
+
+	//回應累積太多時先送出，送完再繼續執行剩下的指令
+	bool blocked;
+	do
+	{
+		blocked = ExecuteInput(session);
+		if (!SendOutput(session))
+		{
+			CloseSession(session, false);
+			return;
+		}
+	} while (blocked && session.outputSent == session.output.size());
+
+	size_t pendingOutput = session.output.size() - session.outputSent;
+	//不合法的二進位指令之後的資料無法對齊，送出已執行指令的回應與錯誤回應後就關閉
+	bool inputDone = session.game->IsQuit() || session.failed || (session.readClosed && session.inputUsed == 0);
+	if (inputDone && pendingOutput == 0)
+	{
+		CloseSession(session, !session.failed);
+		return;
+	}
+
+	//一行指令超過INPUT_LIMIT還沒有換行，視為錯誤的連線
+	if (!blocked && session.inputUsed >= INPUT_LIMIT)
+	{
+		CloseSession(session, false);
+		return;
+	}
+
+	UpdateEvents(session);
+}
+
+/**
+ * Intent : 讀取連線上所有可讀的資料
+ * Pre :
+ * Post :
+ * \param session 連線
+ * \return 是否成功 (連線錯誤時失敗)
+ */
+bool ServerCore::ReadInput(Session& session)
+{
+	while (!session.readClosed && !session.game->IsQuit() && !session.failed && session.inputUsed < INPUT_LIMIT)
+	{
+		if (session.input.size() - session.inputUsed < READ_CHUNK_SIZE)
+		{
+			session.input.resize(session.inputUsed + READ_CHUNK_SIZE);
+		}
+
+		ssize_t received = recv(session.fd, session.input.data() + session.inputUsed, session.input.size() - session.inputUsed, 0);
+		if (received > 0)
+		{
+			session.inputUsed += (size_t)received;
+			session.receivedTotal += (long long)received;
+			session.receives.push_back(make_pair(session.receivedTotal, chrono::steady_clock::now()));
+		}
+		else if (received == 0)
+		{
+			session.readClosed = true;
+		}
+		else if (errno == EAGAIN || errno == EWOULDBLOCK)
+		{
+			break;
+		}
+		else if (errno != EINTR)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Intent : 依序執行已收到的完整指令，直到回應累積超過OUTPUT_LIMIT或遊戲Quit
+ * Pre :
+ * Post : 執行過的指令從input移除
+ * \param session 連線
+ * \return 是否因為回應累積太多而暫停
+ */
+bool ServerCore::ExecuteInput(Session& session)
+{
+	const char* commandStart = session.input.data();
+	const char* inputEnd = commandStart + session.inputUsed;
+	bool blocked = false;
+
+	if (!session.protocolKnown && session.inputUsed > 0)
+	{
+		session.protocolKnown = true;
+		session.binary = (unsigned char)session.input[0] == BinaryProtocolCore::MAGIC;
+	}
+
+	while (commandStart < inputEnd && !session.game->IsQuit())
+	{
+		if (session.output.size() - session.outputSent >= OUTPUT_LIMIT)
+		{
+			blocked = true;
+			break;
+		}
+
+		const char* commandEnd;
+		const char* nextStart;
+		BinaryRequest request;
+		if (session.binary)
+		{
+			size_t frameSize = 0;
+			BinaryFrameStatus status = BinaryProtocolCore::ParseRequest(reinterpret_cast<const unsigned char*>(commandStart), inputEnd - commandStart, request, frameSize);
+
+			//對方已關閉寫入端時，不完整的frame也不會再補齊，回應錯誤後不再執行
+			if (status == BinaryFrameStatus::INVALID || (status == BinaryFrameStatus::INCOMPLETE && session.readClosed))
+			{
+				session.game->RejectBinaryFrame(status);
+				session.failed = true;
+				break;
+			}
+			if (status == BinaryFrameStatus::INCOMPLETE)
+			{
+				break;
+			}
+			commandEnd = commandStart + frameSize;
+			nextStart = commandEnd;
+		}
+		else
+		{
+			//對方已關閉寫入端時，最後一行沒有換行也執行
+			const char* newline = static_cast<const char*>(memchr(commandStart, '\n', inputEnd - commandStart));
+			if (newline == nullptr && !session.readClosed)
+			{
+				break;
+			}
+			commandEnd = newline != nullptr ? newline : inputEnd;
+			nextStart = newline != nullptr ? newline + 1 : inputEnd;
+		}
+
+		//延遲從收到這個指令最後一個byte的那次讀取開始計算
+		long long commandEndTotal = session.consumedTotal + (commandEnd - session.input.data());
+		while (session.receives.front().first < commandEndTotal)
+		{
+			session.receives.pop_front();
+		}
+
+		long long executedCount = session.game->GetCommandCount();
+		if (session.binary)
+		{
+			session.game->ExecuteBinaryCommand(request, commandStart + BinaryProtocolCore::REQUEST_SIZE);
+		}
+		else
+		{
+			session.game->ExecuteCommand(commandStart, commandEnd - commandStart);
+		}
+		if (session.game->GetCommandCount() != executedCount)
+		{
+			session.pending.push_back(make_pair(session.producedTotal, session.receives.front().second));
+			commandCount++;
+		}
+
+		commandStart = nextStart;
+	}
+
+	//Quit或不合法的frame之後的資料不再執行
+	if (session.game->IsQuit() || session.failed)
+	{
+		commandStart = inputEnd;
+	}
+
+	session.consumedTotal += commandStart - session.input.data();
+	session.inputUsed = inputEnd - commandStart;
+	memmove(session.input.data(), commandStart, session.inputUsed);
+	if (session.inputUsed == 0)
+	{
+		session.receives.clear();
+	}
+	return blocked;
+}
+
+/**
+ * Intent : 盡可能送出回應，並記錄完全送出的指令的延遲
+ * Pre :
+ * Post :
+ * \param session 連線
+ * \return 是否成功 (連線錯誤時失敗)
+ */
+bool ServerCore::SendOutput(Session& session)
+{
+	while (session.outputSent < session.output.size())
+	{
+		ssize_t sent = send(session.fd, session.output.data() + session.outputSent, session.output.size() - session.outputSent, MSG_NOSIGNAL);
+		if (sent > 0)
+		{
+			session.outputSent += (size_t)sent;
+			session.sentTotal += (long long)sent;
+		}
+		else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			break;
+		}
+		else if (sent < 0 && errno != EINTR)
+		{
+			return false;
+		}
+	}
+
+	if (!session.pending.empty() && session.pending.front().first <= session.sentTotal)
+	{
+		chrono::steady_clock::time_point now = chrono::steady_clock::now();
+		while (!session.pending.empty() && session.pending.front().first <= session.sentTotal)
+		{
+			latency.Add((uint64_t)chrono::duration_cast<chrono::nanoseconds>(now - session.pending.front().second).count());
+			session.pending.pop_front();
+		}
+	}
+
+	//全部送出後重複使用同一塊buffer
+	if (session.outputSent == session.output.size())
+	{
+		session.output.clear();
+		session.outputSent = 0;
+	}
+	return true;
+}
+
+/**
+ * Intent : 依照連線狀態更新向epoll註冊的事件
+ * Pre :
+ * Post :
+ * \param session 連線
+ */
+void ServerCore::UpdateEvents(Session& session)
+{
+	size_t pendingOutput = session.output.size() - session.outputSent;
+	uint32_t events = 0;
+	if (!session.readClosed && !session.game->IsQuit() && !session.failed && session.inputUsed < INPUT_LIMIT && pendingOutput < OUTPUT_LIMIT)
+	{
+		events |= EPOLLIN | EPOLLRDHUP;
+	}
+	if (pendingOutput > 0)
+	{
+		events |= EPOLLOUT;
+	}
+
+	if (events == session.events)
+	{
+		return;
+	}
+
+	epoll_event event;
+	memset(&event, 0, sizeof(event));
+	event.events = events;
+	event.data.fd = session.fd;
+	epoll_ctl(epollFd, session.events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, session.fd, &event);
+	session.events = events;
+}
+
+/**
+ * Intent : 關閉連線
+ * Pre :
+ * Post :
+ * \param session 連線
+ * \param completed 是否正常結束 (Quit或對方關閉且回應都已送出)
+ */
+void ServerCore::CloseSession(Session& session, bool completed)
+{
+	int fd = session.fd;
+	if (session.events != 0)
+	{
+		epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+	}
+	close(fd);
+
+	activeCount--;
+	if (completed)
+	{
+		completedCount++;
+	}
+	sessions[fd].reset();
+
+	//釋放了一個file descriptor，等待中的連線可以再被接受
+	if (acceptPaused && listenFd >= 0)
+	{
+		SetAcceptEnabled(true);
+	}
+}
+#endif
+
+/**
+ * Intent : 印出統計結果
+ * Pre :
+ * Post :
+ * \param report 印出結果的stream
+ * \param seconds 伺服器執行的時間
+ */
+void ServerCore::Report(std::ostream& report, double seconds)
+{
+	double rateSeconds = max(seconds, 1e-9);
+	report << "Sessions : " << openedCount << " opened, " << completedCount << " completed" << endl;
+	report << "Commands : " << commandCount << endl;
+	report << fixed << setprecision(1);
+	report << "Latency : p50 " << latency.Percentile(0.5) / 1000.0 << " us, p99 " << latency.Percentile(0.99) / 1000.0 << " us, max " << latency.maxValue / 1000.0 << " us" << endl;
+	report << setprecision(3) << "Time : " << seconds << " s" << endl;
+	report << setprecision(1) << "Throughput : " << completedCount / rateSeconds << " sessions/sec, " << commandCount / rateSeconds << " commands/sec" << endl;
+}
+
+/**
+ * Intent : 加入一筆延遲
+ * Pre :
+ * Post :
+ * \param value 延遲 (奈秒)
+ */
+void ServerCore::LatencyHistogram::Add(std::uint64_t value)
+{
+	//小於16直接對應，其餘依最高位元分段，再取最高位元之後的4個位元分成16格
+	size_t index;
+	if (value < 16)
+	{
+		index = (size_t)value;
+	}
+	else
+	{
+		int exponent = 4;
+		while ((value >> (exponent + 1)) != 0)
+		{
+			exponent++;
+		}
+		index = (size_t)(exponent - 3) * 16 + (size_t)((value >> (exponent - 4)) & 15);
+	}
+
+	buckets[index]++;
+	count++;
+	maxValue = max(maxValue, value);
+}
+
+/**
+ * Intent : 回傳百分位數
+ * Pre :
+ * Post :
+ * \param ratio 百分位 (0~1)
+ * \return 延遲 (奈秒)
+ */
+std::uint64_t ServerCore::LatencyHistogram::Percentile(double ratio) const
+{
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	//第一個累計數量達到百分位的格子，回傳格子的中間值
+	uint64_t target = max((uint64_t)1, (uint64_t)(ratio * count + 0.5));
+	uint64_t accumulated = 0;
+	for (size_t index = 0; index < buckets.size(); index++)
+	{
+		accumulated += buckets[index];
+		if (accumulated >= target)
+		{
+			if (index < 16)
+			{
+				return index;
+			}
+			int shift = (int)(index / 16) - 1;
+			uint64_t lower = (uint64_t)(16 + index % 16) << shift;
+			return min(lower + ((uint64_t)1 << shift) / 2, maxValue);
+		}
+	}
+	return maxValue;
+}
@@ -0,0 +1,261 @@
+﻿/*****************************************************************//**
+ * File : ServerCore.h
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api header of MineSweeperExample
+ *********************************************************************/
+
+#pragma once
+#ifndef _SERVERCORE_H_
+#define _SERVERCORE_H_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MineSweeperCore.h"
+#include "SessionPoolCore.h"
+
+//本機多人遊戲伺服器 : 在Unix domain socket上以epoll同時服務大量連線 (只支援Linux)
+//每個連線是一個獨立的MineSweeperCore，使用與指令輸入模式相同的文字指令，一次送來多行指令時依序執行 (pipelining)
+//Quit只結束該連線的遊戲，伺服器收到SIGINT/SIGTERM或Stop時結束，並印出延遲與throughput統計
+class ServerCore
+{
+public:
+
+	//ServerCore constructor
+	ServerCore(std::string);
+
+	//ServerCore destructor
+	~ServerCore();
+
+	//伺服器綁定socket與epoll，不能複製
+	ServerCore(const ServerCore&) = delete;
+	ServerCore& operator=(const ServerCore&) = delete;
+
+	/**
+	 * Intent : 開始監聽socket並處理連線，直到收到SIGINT/SIGTERM或Stop
+	 * Pre :
+	 * Post : 所有連線關閉、socket檔案移除，統計結果印到report
+	 * \param report 印出狀態與統計結果的stream
+	 * \return 是否成功啟動
+	 */
+	bool Run(std::ostream&);
+
+	/**
+	 * Intent : 要求伺服器結束 (可以從其他執行緒呼叫)
+	 * Pre :
+	 * Post : Run在處理完目前的事件後返回
+	 */
+	void Stop();
+
+private:
+
+	//一個連線的狀態
+	struct Session
+	{
+		//Session constructor
+		Session(int);
+
+		//Session destructor
+		~Session();
+
+		//連線的file descriptor
+		int fd;
+
+		//收到但還沒執行的指令
+		std::vector<char> input;
+		size_t inputUsed = 0;
+
+		//累計收到與執行過的指令大小，以及每次讀取的結尾位置與時間，用來找出每行指令收到的時間
+		long long receivedTotal = 0;
+		long long consumedTotal = 0;
+		std::deque<std::pair<long long, std::chrono::steady_clock::time_point>> receives;
+
+		//還沒送出的回應
+		std::vector<char> output;
+		size_t outputSent = 0;
+
+		//累計產生與送出的回應大小，用來判斷每個指令的回應何時完全送出
+		long long producedTotal = 0;
+		long long sentTotal = 0;
+
+		//等待送出的指令 : 回應的結尾位置與指令收到的時間
+		std::deque<std::pair<long long, std::chrono::steady_clock::time_point>> pending;
+
+		//對方是否已關閉寫入端
+		bool readClosed = false;
+
+		//由第一個byte判斷的協定 : 以BinaryProtocolCore::MAGIC開頭為二進位指令，否則為文字指令
+		bool protocolKnown = false;
+		bool binary = false;
+
+		//收到不合法的二進位指令，之後的資料無法對齊
+		bool failed = false;
+
+		//目前向epoll註冊的事件
+		std::uint32_t events = 0;
+
+		//這個連線的遊戲 (由SessionPoolCore取得，連線結束時歸還)，回應直接寫進output
+		std::unique_ptr<MineSweeperCore> game;
+	};
+
+	//延遲直方圖 (奈秒) : 以2的次方分段、每段再分16格，記憶體固定且誤差在1/16以內
+	struct LatencyHistogram
+	{
+		/**
+		 * Intent : 加入一筆延遲
+		 * Pre :
+		 * Post :
+		 * \param value 延遲 (奈秒)
+		 */
+		void Add(std::uint64_t);
+
+		/**
+		 * Intent : 回傳百分位數
+		 * Pre :
+		 * Post :
+		 * \param ratio 百分位 (0~1)
+		 * \return 延遲 (奈秒)
+		 */
+		std::uint64_t Percentile(double) const;
+
+		std::array<std::uint64_t, 976> buckets = {};
+		std::uint64_t count = 0;
+		std::uint64_t maxValue = 0;
+	};
+
+	/**
+	 * Intent : 建立監聽socket、epoll與喚醒用的eventfd
+	 * Pre :
+	 * Post :
+	 * \param report 印出錯誤的stream
+	 * \return 是否成功
+	 */
+	bool Open(std::ostream&);
+
+	/**
+	 * Intent : 關閉所有連線與file descriptor，移除socket檔案
+	 * Pre :
+	 * Post :
+	 */
+	void Close();
+
+	/**
+	 * Intent : 接受所有等待中的連線
+	 * Pre :
+	 * Post :
+	 */
+	void AcceptSessions();
+
+	/**
+	 * Intent : 開始或暫停監聽新的連線 (file descriptor用完時暫停，避免epoll一直回報監聽socket可讀)
+	 * Pre :
+	 * Post :
+	 * \param enabled 是否監聽
+	 */
+	void SetAcceptEnabled(bool);
+
+	/**
+	 * Intent : 處理一個連線的epoll事件 : 讀取、執行指令、送出回應，結束時關閉連線
+	 * Pre :
+	 * Post :
+	 * \param session 連線
+	 * \param events epoll事件
+	 */
+	void HandleSession(Session&, std::uint32_t);
+
+	/**
+	 * Intent : 讀取連線上所有可讀的資料
+	 * Pre :
+	 * Post :
+	 * \param session 連線
+	 * \return 是否成功 (連線錯誤時失敗)
+	 */
+	bool ReadInput(Session&);
+
+	/**
+	 * Intent : 依序執行已收到的完整指令(文字或二進位)，直到回應累積超過OUTPUT_LIMIT或遊戲Quit
+	 * Pre :
+	 * Post : 執行過的指令從input移除，二進位指令不合法時設定failed
+	 * \param session 連線
+	 * \return 是否因為回應累積太多而暫停
+	 */
+	bool ExecuteInput(Session&);
+
+	/**
+	 * Intent : 盡可能送出回應，並記錄完全送出的指令的延遲
+	 * Pre :
+	 * Post :
+	 * \param session 連線
+	 * \return 是否成功 (連線錯誤時失敗)
+	 */
+	bool SendOutput(Session&);
+
+	/**
+	 * Intent : 依照連線狀態更新向epoll註冊的事件
+	 * Pre :
+	 * Post :
+	 * \param session 連線
+	 */
+	void UpdateEvents(Session&);
+
+	/**
+	 * Intent : 關閉連線
+	 * Pre :
+	 * Post :
+	 * \param session 連線
+	 * \param completed 是否正常結束 (Quit或對方關閉且回應都已送出)
+	 */
+	void CloseSession(Session&, bool);
+
+	/**
+	 * Intent : 印出統計結果
+	 * Pre :
+	 * Post :
+	 * \param report 印出結果的stream
+	 * \param seconds 伺服器執行的時間
+	 */
+	void Report(std::ostream&, double);
+
+	//每次從socket讀取的大小、未執行指令與未送出回應的上限 (超過時暫停讀取)
+	static const size_t READ_CHUNK_SIZE = 1 << 16;
+	static const size_t INPUT_LIMIT = 1 << 20;
+	static const size_t OUTPUT_LIMIT = 1 << 22;
+
+	//一個Print回應最多印出的格子數 (每格2 byte，一個回應約為OUTPUT_LIMIT)，回應在執行指令時一次寫進output，不受OUTPUT_LIMIT限制
+	static const long long PRINT_CELL_LIMIT = OUTPUT_LIMIT / 2;
+
+	//暫停監聽後，沒有連線關閉時重新嘗試accept的間隔 (毫秒)
+	static const int ACCEPT_RETRY_MS = 100;
+
+	//socket檔案路徑
+	std::string socketPath;
+
+	//監聽socket、epoll與喚醒用eventfd
+	int listenFd = -1;
+	int epollFd = -1;
+	int wakeFd = -1;
+
+	//file descriptor用完，暫停監聽新的連線
+	bool acceptPaused = false;
+
+	//以file descriptor為索引的連線
+	std::vector<std::unique_ptr<Session>> sessions;
+
+	//統計
+	long long activeCount = 0;
+	long long openedCount = 0;
+	long long completedCount = 0;
+	long long commandCount = 0;
+	LatencyHistogram latency;
+};
+
+#endif // !_SERVERCORE_H_
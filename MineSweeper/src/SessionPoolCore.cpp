@@ -0,0 +1,122 @@
+﻿/*****************************************************************//**
+ * File : SessionPoolCore.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api implementation of MineSweeperExample
+ *********************************************************************/
+
+#include "SessionPoolCore.h"
+
+using namespace std;
+
+//SessionPoolCore constructor
+SessionPoolCore::SessionPoolCore(size_t _maxIdle, size_t _maxIdleBytes) : maxIdle(_maxIdle), maxIdleBytes(_maxIdleBytes)
+{
+	idle.reserve(maxIdle);
+}
+
+//SessionPoolCore destructor
+SessionPoolCore::~SessionPoolCore()
+{
+
+}
+
+/**
+ * Intent : 獲取全域共用的遊戲實例pool
+ * Pre :
+ * Post :
+ * \return 全域共用的遊戲實例pool
+ */
+SessionPoolCore& SessionPoolCore::Instance()
+{
+	static SessionPoolCore pool(DEFAULT_MAX_IDLE, DEFAULT_MAX_IDLE_BYTES);
+	return pool;
+}
+
+/**
+ * Intent : 取得一個剛Reset的遊戲實例，pool是空的時才建立新的實例
+ * Pre :
+ * Post : 實例為Standby狀態，設定為預設值
+ * \param outputWriter 遊戲的輸出callback
+ * \return 遊戲實例
+ */
+std::unique_ptr<MineSweeperCore> SessionPoolCore::Acquire(OutputSinkCore::Writer outputWriter)
+{
+	unique_ptr<MineSweeperCore> game;
+	{
+		lock_guard<mutex> lock(idleMutex);
+		if (!idle.empty())
+		{
+			game = move(idle.back());
+			idle.pop_back();
+			idleBytes -= game->GetRetainedMemorySize();
+		}
+	}
+
+	if (!game)
+	{
+		game.reset(new MineSweeperCore(outputWriter));
+	}
+	else
+	{
+		game->Reset(outputWriter);
+	}
+	return game;
+}
+
+/**
+ * Intent : 歸還遊戲實例，Reset後放回pool，實例數量或保留的記憶體超過上限時直接釋放
+ * Pre : 實例的輸出已經寫出 (未寫出的輸出會被捨棄)
+ * Post :
+ * \param game 遊戲實例
+ */
+void SessionPoolCore::Release(std::unique_ptr<MineSweeperCore> game)
+{
+	if (!game)
+	{
+		return;
+	}
+
+	//先放開輸出callback與盤面狀態，實例在pool中不會再參考到原本的擁有者
+	game->Reset(OutputSinkCore::Writer());
+	size_t gameBytes = game->GetRetainedMemorySize();
+
+	{
+		lock_guard<mutex> lock(idleMutex);
+		if (idle.size() < maxIdle && idleBytes + gameBytes <= maxIdleBytes)
+		{
+			idleBytes += gameBytes;
+			idle.push_back(move(game));
+			return;
+		}
+	}
+
+	//pool已滿，在lock外釋放實例
+	game.reset();
+}
+
+/**
+ * Intent : 回傳pool中閒置的實例數量
+ * Pre :
+ * Post :
+ * \return 閒置的實例數量
+ */
+size_t SessionPoolCore::GetIdleCount()
+{
+	lock_guard<mutex> lock(idleMutex);
+	return idle.size();
+}
+
+/**
+ * Intent : 回傳pool中閒置的實例保留的記憶體大小
+ * Pre :
+ * Post :
+ * \return 保留的byte數
+ */
+size_t SessionPoolCore::GetIdleMemorySize()
+{
+	lock_guard<mutex> lock(idleMutex);
+	return idleBytes;
+}
@@ -0,0 +1,95 @@
+﻿/*****************************************************************//**
+ * File : SessionPoolCore.h
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api header of MineSweeperExample
+ *********************************************************************/
+
+#pragma once
+#ifndef _SESSIONPOOLCORE_H_
+#define _SESSIONPOOLCORE_H_
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "MineSweeperCore.h"
+#include "OutputSinkCore.h"
+
+//遊戲實例的pool : 結束的遊戲Reset後留著，下一個連線或指令檔直接拿來用
+//實例保留盤面、flood fill與輸出的buffer，反覆的Load/Replay/結束/開始不需要再配置記憶體
+//全域共用，可以被多個執行緒同時存取
+class SessionPoolCore
+{
+public:
+
+	//SessionPoolCore constructor
+	SessionPoolCore(size_t, size_t);
+
+	//SessionPoolCore destructor
+	~SessionPoolCore();
+
+	/**
+	 * Intent : 獲取全域共用的遊戲實例pool
+	 * Pre :
+	 * Post :
+	 * \return 全域共用的遊戲實例pool
+	 */
+	static SessionPoolCore& Instance();
+
+	/**
+	 * Intent : 取得一個剛Reset的遊戲實例，pool是空的時才建立新的實例
+	 * Pre :
+	 * Post : 實例為Standby狀態，設定為預設值
+	 * \param outputWriter 遊戲的輸出callback
+	 * \return 遊戲實例
+	 */
+	std::unique_ptr<MineSweeperCore> Acquire(OutputSinkCore::Writer);
+
+	/**
+	 * Intent : 歸還遊戲實例，Reset後放回pool，實例數量或保留的記憶體超過上限時直接釋放
+	 * Pre : 實例的輸出已經寫出 (未寫出的輸出會被捨棄)
+	 * Post :
+	 * \param game 遊戲實例
+	 */
+	void Release(std::unique_ptr<MineSweeperCore>);
+
+	/**
+	 * Intent : 回傳pool中閒置的實例數量
+	 * Pre :
+	 * Post :
+	 * \return 閒置的實例數量
+	 */
+	size_t GetIdleCount();
+
+	/**
+	 * Intent : 回傳pool中閒置的實例保留的記憶體大小
+	 * Pre :
+	 * Post :
+	 * \return 保留的byte數
+	 */
+	size_t GetIdleMemorySize();
+
+	//全域pool最多保留的閒置實例數量，以及閒置實例合計最多保留的記憶體 (byte)
+	static const size_t DEFAULT_MAX_IDLE = 1024;
+	static const size_t DEFAULT_MAX_IDLE_BYTES = (size_t)1 << 28;
+
+private:
+
+	//閒置的實例 (後進先出，最近用過的實例buffer還在cache中)
+	std::vector<std::unique_ptr<MineSweeperCore>> idle;
+
+	//最多保留的閒置實例數量
+	size_t maxIdle;
+
+	//閒置實例合計保留的記憶體與上限 (byte)
+	size_t idleBytes = 0;
+	size_t maxIdleBytes;
+
+	//保護idle與idleBytes
+	std::mutex idleMutex;
+};
+
+#endif // !_SESSIONPOOLCORE_H_
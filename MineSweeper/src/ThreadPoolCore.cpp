@@ -0,0 +1,157 @@
+﻿/*****************************************************************//**
+ * File : ThreadPoolCore.cpp
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api implementation of MineSweeperExample
+ *********************************************************************/
+
+#include "ThreadPoolCore.h"
+
+using namespace std;
+
+//ThreadPoolCore constructor
+ThreadPoolCore::ThreadPoolCore(int workerCount)
+{
+	for (int i = 0; i < workerCount; i++)
+	{
+		workers.emplace_back(&ThreadPoolCore::WorkerLoop, this);
+	}
+}
+
+//ThreadPoolCore destructor
+ThreadPoolCore::~ThreadPoolCore()
+{
+	{
+		lock_guard<mutex> lock(queueMutex);
+		stopping = true;
+	}
+	queueCondition.notify_all();
+
+	for (thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+/**
+ * Intent : 獲取全域共用的worker pool (worker數量為硬體執行緒數量-1，呼叫端自己也會一起工作)
+ * Pre :
+ * Post :
+ * \return 全域共用的worker pool
+ */
+ThreadPoolCore& ThreadPoolCore::Instance()
+{
+	static ThreadPoolCore pool(HardwareThreadCount() - 1);
+	return pool;
+}
+
+/**
+ * Intent : 獲取硬體執行緒數量
+ * Pre :
+ * Post :
+ * \return 硬體執行緒數量 (至少為1)
+ */
+int ThreadPoolCore::HardwareThreadCount()
+{
+	unsigned int count = thread::hardware_concurrency();
+	return count == 0 ? 1 : (int)count;
+}
+
+/**
+ * Intent : 計算除了呼叫端以外要使用幾個worker
+ * Pre :
+ * Post :
+ * \param taskCount 工作數量
+ * \param maxThreads 最多同時使用的執行緒數量 (含呼叫端)
+ * \return worker數量 (0以下代表直接在呼叫端執行)
+ */
+int ThreadPoolCore::HelperCount(int taskCount, int maxThreads)
+{
+	return min(min(maxThreads, taskCount) - 1, (int)workers.size());
+}
+
+/**
+ * Intent : 把工作交給worker與呼叫端一起執行，每個執行緒用atomic計數器動態領取下一個工作，全部完成後才回傳
+ * Pre : HelperCount大於0
+ * Post : 所有工作都已完成
+ * \param taskCount 工作數量
+ * \param task 工作內容，參數為工作編號 [0, taskCount)
+ * \param maxThreads 最多同時使用的執行緒數量 (含呼叫端)
+ */
+void ThreadPoolCore::RunBatch(int taskCount, const std::function<void(int)>& task, int maxThreads)
+{
+	int helperCount = HelperCount(taskCount, maxThreads);
+
+	shared_ptr<Batch> batch = make_shared<Batch>();
+	batch->task = task;
+	batch->taskCount = taskCount;
+
+	{
+		lock_guard<mutex> lock(queueMutex);
+		for (int i = 0; i < helperCount; i++)
+		{
+			pendingBatches.push_back(batch);
+		}
+	}
+	queueCondition.notify_all();
+
+	//呼叫端也一起領取工作
+	Drain(*batch);
+
+	//等待其他執行緒手上的工作完成
+	unique_lock<mutex> lock(batch->doneMutex);
+	batch->doneCondition.wait(lock, [&batch]() { return batch->doneCount == batch->taskCount; });
+}
+
+/**
+ * Intent : 不斷領取batch中的工作直到領完
+ * Pre :
+ * Post :
+ * \param batch 要處理的batch
+ */
+void ThreadPoolCore::Drain(Batch& batch)
+{
+	int finished = 0;
+	int taskIndex;
+	while ((taskIndex = batch.nextTask.fetch_add(1)) < batch.taskCount)
+	{
+		batch.task(taskIndex);
+		finished++;
+	}
+
+	if (finished > 0)
+	{
+		lock_guard<mutex> lock(batch.doneMutex);
+		batch.doneCount += finished;
+		if (batch.doneCount == batch.taskCount)
+		{
+			batch.doneCondition.notify_all();
+		}
+	}
+}
+
+/**
+ * Intent : worker執行緒的主迴圈
+ * Pre :
+ * Post : pool解構時結束
+ */
+void ThreadPoolCore::WorkerLoop()
+{
+	while (true)
+	{
+		shared_ptr<Batch> batch;
+		{
+			unique_lock<mutex> lock(queueMutex);
+			queueCondition.wait(lock, [this]() { return stopping || !pendingBatches.empty(); });
+			if (stopping && pendingBatches.empty())
+			{
+				return;
+			}
+			batch = pendingBatches.front();
+			pendingBatches.pop_front();
+		}
+		Drain(*batch);
+	}
+}
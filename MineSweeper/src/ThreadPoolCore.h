@@ -0,0 +1,134 @@
+﻿/*****************************************************************//**
+ * File : ThreadPoolCore.h
+ * Author : agent (agent@local)
+ * Create Date : 2026-10-17
+ * Editor : agent (agent@local)
+ * Update Date : 2026-10-17
+ * Description : This is the Core api header of MineSweeperExample
+ *********************************************************************/
+
+#pragma once
+#ifndef _THREADPOOLCORE_H_
+#define _THREADPOOLCORE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPoolCore
+{
+public:
+
+	//ThreadPoolCore constructor
+	ThreadPoolCore(int);
+
+	//ThreadPoolCore destructor
+	~ThreadPoolCore();
+
+	/**
+	 * Intent : 獲取全域共用的worker pool (worker數量為硬體執行緒數量-1，呼叫端自己也會一起工作)
+	 * Pre :
+	 * Post :
+	 * \return 全域共用的worker pool
+	 */
+	static ThreadPoolCore& Instance();
+
+	/**
+	 * Intent : 獲取硬體執行緒數量
+	 * Pre :
+	 * Post :
+	 * \return 硬體執行緒數量 (至少為1)
+	 */
+	static int HardwareThreadCount();
+
+	/**
+	 * Intent : 平行執行taskCount個工作，每個執行緒用atomic計數器動態領取下一個工作，全部完成後才回傳
+	 * Pre : 工作之間沒有相依性
+	 * Post : 所有工作都已完成
+	 * \param taskCount 工作數量
+	 * \param task 工作內容，參數為工作編號 [0, taskCount)
+	 * \param maxThreads 最多同時使用的執行緒數量 (含呼叫端)
+	 */
+	template <typename Task>
+	void Run(int taskCount, const Task& task, int maxThreads)
+	{
+		//只有一個執行緒可用時，直接在呼叫端依序執行，不需要包成std::function (不配置記憶體)
+		if (HelperCount(taskCount, maxThreads) <= 0)
+		{
+			for (int i = 0; i < taskCount; i++)
+			{
+				task(i);
+			}
+			return;
+		}
+		RunBatch(taskCount, task, maxThreads);
+	}
+
+private:
+
+	/**
+	 * Intent : 計算除了呼叫端以外要使用幾個worker
+	 * Pre :
+	 * Post :
+	 * \param taskCount 工作數量
+	 * \param maxThreads 最多同時使用的執行緒數量 (含呼叫端)
+	 * \return worker數量 (0以下代表直接在呼叫端執行)
+	 */
+	int HelperCount(int, int);
+
+	/**
+	 * Intent : 把工作交給worker與呼叫端一起執行，全部完成後才回傳
+	 * Pre : HelperCount大於0
+	 * Post : 所有工作都已完成
+	 * \param taskCount 工作數量
+	 * \param task 工作內容，參數為工作編號 [0, taskCount)
+	 * \param maxThreads 最多同時使用的執行緒數量 (含呼叫端)
+	 */
+	void RunBatch(int, const std::function<void(int)>&, int);
+
+	//一次Run呼叫的共享狀態，worker可能比Run晚結束，因此用shared_ptr管理
+	struct Batch
+	{
+		std::function<void(int)> task;
+		int taskCount = 0;
+		std::atomic<int> nextTask{ 0 };
+		int doneCount = 0;
+		std::mutex doneMutex;
+		std::condition_variable doneCondition;
+	};
+
+	/**
+	 * Intent : 不斷領取batch中的工作直到領完
+	 * Pre :
+	 * Post :
+	 * \param batch 要處理的batch
+	 */
+	static void Drain(Batch&);
+
+	/**
+	 * Intent : worker執行緒的主迴圈
+	 * Pre :
+	 * Post : pool解構時結束
+	 */
+	void WorkerLoop();
+
+	//worker執行緒
+	std::vector<std::thread> workers;
+
+	//等待被worker領取的batch
+	std::deque<std::shared_ptr<Batch>> pendingBatches;
+
+	//保護pendingBatches與stopping
+	std::mutex queueMutex;
+	std::condition_variable queueCondition;
+
+	//pool是否正在關閉
+	bool stopping = false;
+};
+
+#endif // !_THREADPOOLCORE_H_
@@ -10,11 +10,18 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
 #include <QMainWindow>
 #include <QtMultimedia/QMediaPlayer>
 #include <QtMultimedia/QMediaPlaylist>
 
 #include "MineSweeperCore.h"
+#include "BoardCacheCore.h"
+#include "CommandBatchCore.h"
+#include "ServerCore.h"
 #include "MineSweeperGUI.h"
 
 using namespace std;
@@ -28,11 +35,11 @@ using namespace std;
  */
 void RunCommandFile(string commandFilename, string outputFilename)
 {
-	MineSweeperCore game;
 	ofstream outputFile(outputFilename);
-	std::cout.rdbuf(outputFile.rdbuf()); // 把cout的輸出都導入到輸出檔案，這樣就可以統一使用cout來印出結果，而不用進行stream的切換
+
+	//遊戲的輸出直接寫到輸出檔案，不需要改變全域的cout
+	MineSweeperCore game(outputFile);
 	game.ExecuteCommandFile(commandFilename);
-	outputFile.close();
 }
 
 /**
@@ -52,6 +59,43 @@ void RunCommandInput()
 	}
 }
 
+/**
+ * Intent : 執行二進位指令輸入模式，從stdin讀取二進位指令frame，回應寫到stdout
+ * Pre : Start Program
+ * Post : End Program
+ */
+void RunBinaryInput()
+{
+#ifdef _WIN32
+	//Windows的stdin/stdout預設為文字模式，會轉換換行字元
+	_setmode(_fileno(stdin), _O_BINARY);
+	_setmode(_fileno(stdout), _O_BINARY);
+#endif
+	ios::sync_with_stdio(false);
+
+	MineSweeperCore game;
+	game.ExecuteBinaryStream(cin);
+}
+
+/**
+ * Intent : 設定整個程序共用的盤面檔快取記憶體上限
+ * Pre : Start Program
+ * Post :
+ * \param limitText 記憶體上限 (byte) 的字串，0代表停用快取
+ * \return 是否為合法的上限
+ */
+bool SetBoardCacheLimit(const string& limitText)
+{
+	//防呆機制 : 只接受不超過19位數的非負整數
+	if (limitText.empty() || limitText.size() > 19 || limitText.find_first_not_of("0123456789") != string::npos)
+	{
+		return false;
+	}
+
+	BoardCacheCore::Instance().SetMemoryLimit(stoull(limitText));
+	return true;
+}
+
 /**
  * Intent : 執行GUI模式
  * Pre : Start Program
@@ -105,11 +149,42 @@ int main(int argc, char* argv[])
 		//執行指令檔模式
 		RunCommandFile(argv[2], argv[3]);
 	}
+	else if (string(argv[1]) == string("CommandBatch") && (argc == 4 || argc == 5))
+	{
+		//批次指令檔模式 (資料夾或manifest，平行執行並與預期輸出比對)，可選的盤面檔快取上限 (byte)
+		if (argc == 5 && !SetBoardCacheLimit(argv[4]))
+		{
+			cout << "arg error!" << endl;
+			return 0;
+		}
+		return CommandBatchCore::Run(argv[2], argv[3], cout) ? 0 : 1;
+	}
+	else if (string(argv[1]) == string("Server") && (argc == 3 || argc == 4))
+	{
+		//本機多人遊戲伺服器模式 (Unix domain socket)，SIGINT/SIGTERM結束並印出統計，可選的盤面檔快取上限 (byte)
+		if (argc == 4 && !SetBoardCacheLimit(argv[3]))
+		{
+			cout << "arg error!" << endl;
+			return 0;
+		}
+		ServerCore server(argv[2]);
+		return server.Run(cout) ? 0 : 1;
+	}
+	else if (string(argv[1]) == string("ConvertBoard") && argc == 4)
+	{
+		//盤面檔格式轉換模式 (文字格式<->二進位格式)
+		cout << (BoardFileCore::ConvertBoard(argv[2], argv[3]) ? "Success" : "Failed") << endl;
+	}
 	else if (string(argv[1]) == string("CommandInput") && argc == 2)
 	{
 		//執行指令輸入模式
 		RunCommandInput();
 	}
+	else if (string(argv[1]) == string("BinaryInput") && argc == 2)
+	{
+		//執行二進位指令輸入模式
+		RunBinaryInput();
+	}
 	else if (string(argv[1]) == string("GUI") && argc == 2)
 	{
 		//執行GUI模式